@@ -28,6 +28,12 @@ public class CISQLite3 : ModuleRules
       new string[] {}
     );
 
+    if (Target.bBuildEditor)
+    {
+      // Notices database files changing on disk, see FSQLiteConnectionPool::StartWatchingFile
+      PrivateDependencyModuleNames.Add("DirectoryWatcher");
+    }
+
     DynamicallyLoadedModuleNames.AddRange(
       new string[] {}
     );
@@ -7,8 +7,20 @@ DEFINE_LOG_CATEGORY(LogDatabase)
 
 #define LOCTEXT_NAMESPACE "FCISQLite3"
 
-void FCISQLite3::StartupModule() {}
-void FCISQLite3::ShutdownModule() {}
+void FCISQLite3::StartupModule()
+{
+  PruneTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([](float DeltaTime)
+  {
+    USQLiteDatabase::PruneIdleConnections();
+    return true;
+  }), 1.0f);
+}
+
+void FCISQLite3::ShutdownModule()
+{
+  FTSTicker::GetCoreTicker().RemoveTicker(PruneTickerHandle);
+  USQLiteDatabase::UnregisterAllDatabases();
+}
 
 #undef LOCTEXT_NAMESPACE
 
@@ -0,0 +1,353 @@
+#include "SQLiteBindingPlan.h"
+#include "CISQLite3PrivatePCH.h"
+#include "Hash/CityHash.h"
+
+FRWLock FSQLiteBindingPlan::CacheLock;
+TMap<TPair<const UStruct*, const FSQLiteColumns*>, FSQLiteBindingPlan::FCacheEntry> FSQLiteBindingPlan::Cache;
+
+/** Entries of unloaded classes and finalized statements are only dropped once the cache grows past this */
+static const int32 BindingPlanCacheTrimSize = 256;
+
+//--------------------------------------------------------------------------------------------------------------
+
+FSQLiteBindingPlan::FSQLiteBindingPlan(const UStruct* Struct, const FSQLiteColumns& Columns)
+{
+	TMap<FString, FProperty*> properties;
+	for (TFieldIterator<FProperty> propIt(Struct, EFieldIteratorFlags::IncludeSuper); propIt; ++propIt)
+	{
+		properties.Add(propIt->GetNameCPP(), *propIt);
+		// Members of structs made in the editor have a generated name, they are matched by the name they were given
+		const FString authoredName = propIt->GetAuthoredName();
+		if (authoredName != propIt->GetNameCPP())
+		{
+			properties.Add(authoredName, *propIt);
+		}
+	}
+
+	Bindings.SetNum(Columns.Num());
+	for (int32 c = 0; c < Columns.Num(); c++)
+	{
+		FProperty* const* found = properties.Find(Columns[c].Name);
+		if (!found)
+		{
+			continue;
+		}
+
+		const FProperty* property = *found;
+		FBinding& binding = Bindings[c];
+		binding.Offset = property->GetOffset_ForInternal();
+
+		const FArrayProperty* arrayProp = CastField<FArrayProperty>(property);
+		if (property->IsA<FInt64Property>()) binding.Kind = EKind::Int64;
+		else if (property->IsA<FIntProperty>()) binding.Kind = EKind::Int32;
+		else if (property->IsA<FInt16Property>()) binding.Kind = EKind::Int16;
+		else if (property->IsA<FInt8Property>()) binding.Kind = EKind::Int8;
+		else if (const FBoolProperty* boolProp = CastField<FBoolProperty>(property))
+		{
+			binding.Kind = EKind::Bool;
+			binding.BoolProperty = boolProp;
+		}
+		else if (property->IsA<FDoubleProperty>()) binding.Kind = EKind::Double;
+		else if (property->IsA<FFloatProperty>()) binding.Kind = EKind::Float;
+		else if (property->IsA<FStrProperty>()) binding.Kind = EKind::String;
+		else if (arrayProp && arrayProp->Inner->IsA<FByteProperty>()) binding.Kind = EKind::Bytes;
+
+		if (binding.Kind != EKind::None)
+		{
+			NumBound++;
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+uint64 FSQLiteBindingPlan::GetLayoutSignature(const UStruct* Struct)
+{
+	uint64 signature = (uint64)Struct->GetStructureSize();
+	for (TFieldIterator<FProperty> propIt(Struct, EFieldIteratorFlags::IncludeSuper); propIt; ++propIt)
+	{
+		const FProperty* property = *propIt;
+		const uint64 layout[3] = { (uint64)(UPTRINT)property, (uint64)(UPTRINT)property->GetClass(), (uint64)property->GetOffset_ForInternal() };
+		signature = CityHash64WithSeed((const char*)layout, sizeof(layout), signature);
+	}
+	return signature;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+TSharedRef<const FSQLiteBindingPlan, ESPMode::ThreadSafe> FSQLiteBindingPlan::Get(const UStruct* Struct, const FSQLiteColumnsPtr& Columns)
+{
+	check(Struct && Columns.IsValid());
+	const TPair<const UStruct*, const FSQLiteColumns*> key(Struct, Columns.Get());
+	const uint64 layoutSignature = GetLayoutSignature(Struct);
+
+	{
+		FRWScopeLock lock(CacheLock, SLT_ReadOnly);
+		const FCacheEntry* entry = Cache.Find(key);
+		// A different struct or column array may have been allocated at the same address since
+		if (entry && entry->Struct.Get() == Struct && entry->Columns.Pin() == Columns && entry->LayoutSignature == layoutSignature)
+		{
+			return entry->Plan.ToSharedRef();
+		}
+	}
+
+	TSharedRef<const FSQLiteBindingPlan, ESPMode::ThreadSafe> plan = MakeShareable(new FSQLiteBindingPlan(Struct, *Columns));
+
+	FRWScopeLock lock(CacheLock, SLT_Write);
+	if (Cache.Num() >= BindingPlanCacheTrimSize)
+	{
+		for (auto it = Cache.CreateIterator(); it; ++it)
+		{
+			if (!it.Value().Struct.IsValid() || !it.Value().Columns.IsValid())
+			{
+				it.RemoveCurrent();
+			}
+		}
+	}
+
+	FCacheEntry& entry = Cache.FindOrAdd(key);
+	entry.Struct = Struct;
+	entry.Columns = Columns;
+	entry.LayoutSignature = layoutSignature;
+	entry.Plan = plan;
+	return plan;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+void FSQLiteBindingPlan::Apply(const SQLiteResultValue& Row, void* Container) const
+{
+	uint8* base = static_cast<uint8*>(Container);
+	for (const SQLiteResultField& field : Row.Fields)
+	{
+		if (!Bindings.IsValidIndex(field.Column))
+		{
+			continue;
+		}
+		const FBinding& binding = Bindings[field.Column];
+		void* value = base + binding.Offset;
+
+		switch (field.Type)
+		{
+		case SQLiteResultValueTypes::Integer:
+			switch (binding.Kind)
+			{
+			case EKind::Int64: *static_cast<int64*>(value) = field.IntValue; break;
+			case EKind::Int32: *static_cast<int32*>(value) = (int32)field.IntValue; break;
+			case EKind::Int16: *static_cast<int16*>(value) = (int16)field.IntValue; break;
+			case EKind::Int8: *static_cast<int8*>(value) = (int8)field.IntValue; break;
+			case EKind::Bool: binding.BoolProperty->SetPropertyValue(value, field.IntValue > 0); break;
+			default: break;
+			}
+			break;
+
+		case SQLiteResultValueTypes::Float:
+			switch (binding.Kind)
+			{
+			case EKind::Double: *static_cast<double*>(value) = field.DoubleValue; break;
+			case EKind::Float: *static_cast<float*>(value) = (float)field.DoubleValue; break;
+			default: break;
+			}
+			break;
+
+		case SQLiteResultValueTypes::Text:
+			if (binding.Kind == EKind::String)
+			{
+				*static_cast<FString*>(value) = field.GetText();
+			}
+			break;
+
+		case SQLiteResultValueTypes::Blob:
+			if (binding.Kind == EKind::Bytes)
+			{
+				const TConstArrayView<uint8> bytes = field.GetBlob();
+				static_cast<TArray<uint8>*>(value)->Reset(bytes.Num());
+				static_cast<TArray<uint8>*>(value)->Append(bytes.GetData(), bytes.Num());
+			}
+			break;
+
+		default:
+			break;
+		}
+	}
+}
+
+void FSQLiteBindingPlan::Apply(sqlite3_stmt* Statement, void* Container) const
+{
+	uint8* base = static_cast<uint8*>(Container);
+	const int32 columnCount = FMath::Min(sqlite3_column_count(Statement), Bindings.Num());
+	for (int32 c = 0; c < columnCount; c++)
+	{
+		const FBinding& binding = Bindings[c];
+		if (binding.Kind == EKind::None)
+		{
+			continue;
+		}
+		void* value = base + binding.Offset;
+
+		switch (sqlite3_column_type(Statement, c))
+		{
+		case SQLITE_INTEGER:
+		{
+			const int64 intValue = sqlite3_column_int64(Statement, c);
+			switch (binding.Kind)
+			{
+			case EKind::Int64: *static_cast<int64*>(value) = intValue; break;
+			case EKind::Int32: *static_cast<int32*>(value) = (int32)intValue; break;
+			case EKind::Int16: *static_cast<int16*>(value) = (int16)intValue; break;
+			case EKind::Int8: *static_cast<int8*>(value) = (int8)intValue; break;
+			case EKind::Bool: binding.BoolProperty->SetPropertyValue(value, intValue > 0); break;
+			default: break;
+			}
+			break;
+		}
+
+		case SQLITE_FLOAT:
+			switch (binding.Kind)
+			{
+			case EKind::Double: *static_cast<double*>(value) = sqlite3_column_double(Statement, c); break;
+			case EKind::Float: *static_cast<float*>(value) = (float)sqlite3_column_double(Statement, c); break;
+			default: break;
+			}
+			break;
+
+		case SQLITE_TEXT:
+			if (binding.Kind == EKind::String)
+			{
+				const ANSICHAR* text = reinterpret_cast<const ANSICHAR*>(sqlite3_column_text(Statement, c));
+				const FUTF8ToTCHAR converted(text, sqlite3_column_bytes(Statement, c));
+				*static_cast<FString*>(value) = FString(converted.Length(), converted.Get());
+			}
+			break;
+
+		case SQLITE_BLOB:
+			if (binding.Kind == EKind::Bytes)
+			{
+				const uint8* data = static_cast<const uint8*>(sqlite3_column_blob(Statement, c));
+				const int32 size = sqlite3_column_bytes(Statement, c);
+				static_cast<TArray<uint8>*>(value)->Reset(size);
+				static_cast<TArray<uint8>*>(value)->Append(data, size);
+			}
+			break;
+
+		default:
+			break;
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+int32 FSQLiteBindingPlan::BindParameters(sqlite3_stmt* Statement, const void* Container) const
+{
+	int32 parameter = 1;
+	for (int32 c = 0; c < Bindings.Num(); c++)
+	{
+		if (Bindings[c].Kind == EKind::None)
+		{
+			continue;
+		}
+		const int32 resultCode = BindParameter(Statement, parameter++, c, Container);
+		if (resultCode != SQLITE_OK)
+		{
+			return resultCode;
+		}
+	}
+	return SQLITE_OK;
+}
+
+int32 FSQLiteBindingPlan::BindParameter(sqlite3_stmt* Statement, int32 Parameter, int32 Column, const void* Container) const
+{
+	const FBinding& binding = Bindings[Column];
+	const void* value = static_cast<const uint8*>(Container) + binding.Offset;
+
+	switch (binding.Kind)
+	{
+	case EKind::Int64: return sqlite3_bind_int64(Statement, Parameter, *static_cast<const int64*>(value));
+	case EKind::Int32: return sqlite3_bind_int64(Statement, Parameter, *static_cast<const int32*>(value));
+	case EKind::Int16: return sqlite3_bind_int64(Statement, Parameter, *static_cast<const int16*>(value));
+	case EKind::Int8: return sqlite3_bind_int64(Statement, Parameter, *static_cast<const int8*>(value));
+	case EKind::Bool: return sqlite3_bind_int(Statement, Parameter, binding.BoolProperty->GetPropertyValue(value) ? 1 : 0);
+	case EKind::Double: return sqlite3_bind_double(Statement, Parameter, *static_cast<const double*>(value));
+	case EKind::Float: return sqlite3_bind_double(Statement, Parameter, *static_cast<const float*>(value));
+
+	case EKind::String:
+	{
+		const FTCHARToUTF8 utf8Value(**static_cast<const FString*>(value));
+		return sqlite3_bind_text(Statement, Parameter, utf8Value.Get(), utf8Value.Length(), SQLITE_TRANSIENT);
+	}
+
+	case EKind::Bytes:
+	{
+		// A null pointer would bind NULL instead of an empty blob
+		static const uint8 emptyBlob = 0;
+		const TArray<uint8>& bytes = *static_cast<const TArray<uint8>*>(value);
+		return sqlite3_bind_blob(Statement, Parameter, bytes.Num() > 0 ? bytes.GetData() : &emptyBlob, bytes.Num(), SQLITE_TRANSIENT);
+	}
+
+	default:
+		return SQLITE_MISUSE;
+	}
+}
+
+FSQLiteValue FSQLiteBindingPlan::GetValue(int32 Column, const void* Container) const
+{
+	const FBinding& binding = Bindings[Column];
+	const void* value = static_cast<const uint8*>(Container) + binding.Offset;
+	FSQLiteValue outValue;
+
+	switch (binding.Kind)
+	{
+	case EKind::Int64: outValue.Type = ESQLiteValueType::Integer; outValue.IntegerValue = *static_cast<const int64*>(value); break;
+	case EKind::Int32: outValue.Type = ESQLiteValueType::Integer; outValue.IntegerValue = *static_cast<const int32*>(value); break;
+	case EKind::Int16: outValue.Type = ESQLiteValueType::Integer; outValue.IntegerValue = *static_cast<const int16*>(value); break;
+	case EKind::Int8: outValue.Type = ESQLiteValueType::Integer; outValue.IntegerValue = *static_cast<const int8*>(value); break;
+	case EKind::Bool: outValue.Type = ESQLiteValueType::Integer; outValue.IntegerValue = binding.BoolProperty->GetPropertyValue(value) ? 1 : 0; break;
+	case EKind::Double: outValue.Type = ESQLiteValueType::Float; outValue.FloatValue = *static_cast<const double*>(value); break;
+	case EKind::Float: outValue.Type = ESQLiteValueType::Float; outValue.FloatValue = *static_cast<const float*>(value); break;
+	case EKind::String: outValue.Type = ESQLiteValueType::Text; outValue.TextValue = *static_cast<const FString*>(value); break;
+	case EKind::Bytes: outValue.Type = ESQLiteValueType::Blob; outValue.BlobValue = *static_cast<const TArray<uint8>*>(value); break;
+	default: break;
+	}
+	return outValue;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+void FSQLiteBindingPlan::GetFingerprints(const void* Container, TArray<uint64>& OutFingerprints) const
+{
+	const uint8* base = static_cast<const uint8*>(Container);
+	OutFingerprints.Reset(NumBound);
+	for (const FBinding& binding : Bindings)
+	{
+		const void* value = base + binding.Offset;
+		uint64 fingerprint = 0;
+
+		switch (binding.Kind)
+		{
+		case EKind::None: continue;
+		case EKind::Int64: fingerprint = *static_cast<const int64*>(value); break;
+		case EKind::Int32: fingerprint = *static_cast<const int32*>(value); break;
+		case EKind::Int16: fingerprint = *static_cast<const int16*>(value); break;
+		case EKind::Int8: fingerprint = *static_cast<const int8*>(value); break;
+		case EKind::Bool: fingerprint = binding.BoolProperty->GetPropertyValue(value) ? 1 : 0; break;
+		case EKind::Double: FMemory::Memcpy(&fingerprint, value, sizeof(double)); break;
+		case EKind::Float: FMemory::Memcpy(&fingerprint, value, sizeof(float)); break;
+
+		case EKind::String:
+		{
+			const FString& text = *static_cast<const FString*>(value);
+			fingerprint = CityHash64(reinterpret_cast<const char*>(*text), text.Len() * sizeof(TCHAR));
+			break;
+		}
+
+		case EKind::Bytes:
+		{
+			const TArray<uint8>& bytes = *static_cast<const TArray<uint8>*>(value);
+			fingerprint = CityHash64(reinterpret_cast<const char*>(bytes.GetData()), bytes.Num());
+			break;
+		}
+		}
+		OutFingerprints.Add(fingerprint);
+	}
+}
@@ -27,6 +27,73 @@ float USQLiteBlueprintFunctionLibrary::CastToFloat(FString SQLiteResultValue)
 
 //--------------------------------------------------------------------------------------------------------------
 
+bool USQLiteBlueprintFunctionLibrary::IsValueNull(const FSQLiteValue& Value)
+{
+	return Value.IsNull();
+}
+
+int32 USQLiteBlueprintFunctionLibrary::ValueToInt(const FSQLiteValue& Value)
+{
+	return (int32)Value.AsInteger();
+}
+
+int64 USQLiteBlueprintFunctionLibrary::ValueToInt64(const FSQLiteValue& Value)
+{
+	return Value.AsInteger();
+}
+
+double USQLiteBlueprintFunctionLibrary::ValueToFloat(const FSQLiteValue& Value)
+{
+	return Value.AsFloat();
+}
+
+bool USQLiteBlueprintFunctionLibrary::ValueToBoolean(const FSQLiteValue& Value)
+{
+	return Value.AsBoolean();
+}
+
+FString USQLiteBlueprintFunctionLibrary::ValueToString(const FSQLiteValue& Value)
+{
+	return Value.AsString();
+}
+
+TArray<uint8> USQLiteBlueprintFunctionLibrary::ValueToBytes(const FSQLiteValue& Value)
+{
+	if (Value.Type == ESQLiteValueType::Blob)
+	{
+		return Value.BlobValue;
+	}
+	if (Value.Type == ESQLiteValueType::Text)
+	{
+		const FTCHARToUTF8 utf8(*Value.TextValue);
+		return TArray<uint8>(reinterpret_cast<const uint8*>(utf8.Get()), utf8.Length());
+	}
+	return TArray<uint8>();
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+int32 USQLiteBlueprintFunctionLibrary::GetColumnIndex(const FSQLiteQueryResult& Result, const FString& ColumnName)
+{
+	return Result.FindColumn(ColumnName);
+}
+
+FString USQLiteBlueprintFunctionLibrary::GetFieldByIndex(const FSQLiteQueryResult& Result, int32 Row, int32 Column)
+{
+	if (!Result.ResultRows.IsValidIndex(Row) || !Result.ResultRows[Row].Fields.IsValidIndex(Column))
+	{
+		return FString();
+	}
+	return Result.ResultRows[Row].Fields[Column].Value;
+}
+
+FString USQLiteBlueprintFunctionLibrary::GetFieldByName(const FSQLiteQueryResult& Result, int32 Row, const FString& ColumnName)
+{
+	return GetFieldByIndex(Result, Row, Result.FindColumn(ColumnName));
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
 FSQLiteQueryTermExpectedNode USQLiteBlueprintFunctionLibrary::QueryStart(FSQLiteQueryTermExpectedNode LogicOperationOrNone)
 {
 	return FSQLiteQueryTermExpectedNode(LogicOperationOrNone.Query, TEXT("("));
@@ -197,3 +264,15 @@ FSQLiteIndex USQLiteBlueprintFunctionLibrary::SQLiteIndexFunction(const TArray<F
 	return i;
 
 }
+
+FSQLiteConnectionProfile USQLiteBlueprintFunctionLibrary::SQLiteReadOnlyContentProfile() {
+	return FSQLiteConnectionProfile::ReadOnlyContent();
+}
+
+FSQLiteConnectionProfile USQLiteBlueprintFunctionLibrary::SQLiteSaveGameProfile() {
+	return FSQLiteConnectionProfile::SaveGame();
+}
+
+FSQLiteConnectionProfile USQLiteBlueprintFunctionLibrary::SQLiteTelemetryProfile() {
+	return FSQLiteConnectionProfile::Telemetry();
+}
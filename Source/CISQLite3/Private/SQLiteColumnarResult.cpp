@@ -0,0 +1,240 @@
+#include "SQLiteColumnarResult.h"
+#include "CISQLite3PrivatePCH.h"
+
+/** REALs as text the way sqlite converts them, so a value reads the same whether its column was promoted or not */
+static FString FloatToString(double Value)
+{
+	return FString::Printf(TEXT("%.15g"), Value);
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+void FSQLiteColumnarResult::Reset(sqlite3_stmt* Statement)
+{
+	NumRows = 0;
+	Columns.Reset();
+
+	const int32 columnCount = sqlite3_column_count(Statement);
+	Columns.SetNum(columnCount);
+	for (int32 c = 0; c < columnCount; c++)
+	{
+		Columns[c].Name = UTF8_TO_TCHAR(sqlite3_column_name(Statement, c));
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+void FSQLiteColumnarResult::AddRow(sqlite3_stmt* Statement)
+{
+	for (int32 c = 0; c < Columns.Num(); c++)
+	{
+		FColumn& column = Columns[c];
+		const int32 cellType = sqlite3_column_type(Statement, c);
+
+		if (cellType == SQLITE_NULL)
+		{
+			column.Nulls.Add(true);
+			switch (column.Type)
+			{
+			case SQLITE_INTEGER: column.Integers.Add(0); break;
+			case SQLITE_FLOAT: column.Floats.Add(0.0); break;
+			case SQLITE_TEXT:
+			case SQLITE_BLOB: column.Offsets.Add(column.Bytes.Num()); break;
+			default: break;
+			}
+			continue;
+		}
+		column.Nulls.Add(false);
+
+		int32 targetType = column.Type;
+		if (targetType == SQLITE_NULL)
+		{
+			targetType = cellType;
+		}
+		else if (targetType == SQLITE_INTEGER && cellType == SQLITE_FLOAT)
+		{
+			targetType = SQLITE_FLOAT;
+		}
+		else if ((targetType == SQLITE_INTEGER || targetType == SQLITE_FLOAT) && (cellType == SQLITE_TEXT || cellType == SQLITE_BLOB))
+		{
+			targetType = cellType;
+		}
+		else if (targetType == SQLITE_TEXT && cellType == SQLITE_BLOB)
+		{
+			targetType = SQLITE_BLOB;
+		}
+		if (targetType != column.Type)
+		{
+			Promote(column, targetType);
+		}
+
+		switch (column.Type)
+		{
+		case SQLITE_INTEGER:
+			column.Integers.Add(sqlite3_column_int64(Statement, c));
+			break;
+		case SQLITE_FLOAT:
+			column.Floats.Add(sqlite3_column_double(Statement, c));
+			break;
+		default:
+		{
+			// Numbers in a TEXT column are stored the way sqlite renders them as text.
+			// sqlite3_column_bytes has to come after the pointer, it reports the converted length
+			const void* data = cellType == SQLITE_BLOB ? sqlite3_column_blob(Statement, c) : sqlite3_column_text(Statement, c);
+			AppendBytes(column, data, sqlite3_column_bytes(Statement, c));
+			break;
+		}
+		}
+	}
+	NumRows++;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+void FSQLiteColumnarResult::Promote(FColumn& Column, int32 NewType) const
+{
+	const bool toBytes = NewType == SQLITE_TEXT || NewType == SQLITE_BLOB;
+
+	if (Column.Type == SQLITE_NULL)
+	{
+		// Every row so far was NULL
+		if (NewType == SQLITE_INTEGER)
+		{
+			Column.Integers.SetNumZeroed(NumRows);
+		}
+		else if (NewType == SQLITE_FLOAT)
+		{
+			Column.Floats.SetNumZeroed(NumRows);
+		}
+		else
+		{
+			Column.Offsets.Init(0, NumRows + 1);
+		}
+	}
+	else if (Column.Type == SQLITE_INTEGER && NewType == SQLITE_FLOAT)
+	{
+		Column.Floats.Reserve(Column.Integers.Num());
+		for (const int64 value : Column.Integers)
+		{
+			Column.Floats.Add((double)value);
+		}
+		Column.Integers.Empty();
+	}
+	else if ((Column.Type == SQLITE_INTEGER || Column.Type == SQLITE_FLOAT) && toBytes)
+	{
+		Column.Offsets.Reserve(NumRows + 1);
+		Column.Offsets.Add(0);
+		for (int32 row = 0; row < NumRows; row++)
+		{
+			if (Column.Nulls[row])
+			{
+				Column.Offsets.Add(Column.Bytes.Num());
+				continue;
+			}
+			const FString text = Column.Type == SQLITE_INTEGER
+				? FString::Printf(TEXT("%lld"), Column.Integers[row])
+				: FloatToString(Column.Floats[row]);
+			const FTCHARToUTF8 utf8(*text);
+			AppendBytes(Column, utf8.Get(), utf8.Length());
+		}
+		Column.Integers.Empty();
+		Column.Floats.Empty();
+	}
+	// TEXT -> BLOB keeps the bytes as they are
+
+	Column.Type = NewType;
+}
+
+void FSQLiteColumnarResult::AppendBytes(FColumn& Column, const void* Data, int32 Length)
+{
+	if (Data && Length > 0)
+	{
+		Column.Bytes.Append(static_cast<const uint8*>(Data), Length);
+	}
+	Column.Offsets.Add(Column.Bytes.Num());
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+int32 FSQLiteColumnarResult::FindColumn(const FString& Name) const
+{
+	return Columns.IndexOfByPredicate([&Name](const FColumn& Column) { return Column.Name == Name; });
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+int64 FSQLiteColumnarResult::GetInt64(int32 Row, int32 Column) const
+{
+	const FColumn& column = Columns[Column];
+	switch (column.Type)
+	{
+	case SQLITE_INTEGER: return column.Integers[Row];
+	case SQLITE_FLOAT: return (int64)column.Floats[Row];
+	case SQLITE_TEXT:
+	case SQLITE_BLOB: return FCString::Atoi64(*GetString(Row, Column));
+	default: return 0;
+	}
+}
+
+double FSQLiteColumnarResult::GetDouble(int32 Row, int32 Column) const
+{
+	const FColumn& column = Columns[Column];
+	switch (column.Type)
+	{
+	case SQLITE_INTEGER: return (double)column.Integers[Row];
+	case SQLITE_FLOAT: return column.Floats[Row];
+	case SQLITE_TEXT:
+	case SQLITE_BLOB: return FCString::Atod(*GetString(Row, Column));
+	default: return 0.0;
+	}
+}
+
+FString FSQLiteColumnarResult::GetString(int32 Row, int32 Column) const
+{
+	const FColumn& column = Columns[Column];
+	if (column.Nulls[Row])
+	{
+		return FString();
+	}
+	switch (column.Type)
+	{
+	case SQLITE_INTEGER: return FString::Printf(TEXT("%lld"), column.Integers[Row]);
+	case SQLITE_FLOAT: return FloatToString(column.Floats[Row]);
+	case SQLITE_TEXT:
+	case SQLITE_BLOB:
+	{
+		const TConstArrayView<uint8> bytes = GetBytes(Row, Column);
+		const FUTF8ToTCHAR converted(reinterpret_cast<const ANSICHAR*>(bytes.GetData()), bytes.Num());
+		return FString(converted.Length(), converted.Get());
+	}
+	default: return FString();
+	}
+}
+
+TConstArrayView<uint8> FSQLiteColumnarResult::GetBytes(int32 Row, int32 Column) const
+{
+	const FColumn& column = Columns[Column];
+	if (column.Type != SQLITE_TEXT && column.Type != SQLITE_BLOB)
+	{
+		return TConstArrayView<uint8>();
+	}
+	const int32 start = column.Offsets[Row];
+	return TConstArrayView<uint8>(column.Bytes.GetData() + start, column.Offsets[Row + 1] - start);
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+SIZE_T FSQLiteColumnarResult::GetAllocatedSize() const
+{
+	SIZE_T size = Columns.GetAllocatedSize();
+	for (const FColumn& column : Columns)
+	{
+		size += column.Name.GetAllocatedSize()
+			+ column.Integers.GetAllocatedSize()
+			+ column.Floats.GetAllocatedSize()
+			+ column.Bytes.GetAllocatedSize()
+			+ column.Offsets.GetAllocatedSize()
+			+ column.Nulls.GetAllocatedSize();
+	}
+	return size;
+}
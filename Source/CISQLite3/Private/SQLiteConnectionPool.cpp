@@ -0,0 +1,861 @@
+#include "SQLiteConnectionPool.h"
+#include "CISQLite3PrivatePCH.h"
+#include "HAL/FileManager.h"
+
+#if WITH_EDITOR
+#include "DirectoryWatcherModule.h"
+#include "IDirectoryWatcher.h"
+#include "Async/Async.h"
+#include "Modules/ModuleManager.h"
+#endif
+
+#define LOGSQLITE(verbosity, text) UE_LOG(LogDatabase, verbosity, TEXT("SQLite: %s"), text)
+
+//--------------------------------------------------------------------------------------------------------------
+
+std::atomic<int32> FSQLiteConnection::NumOpen{ 0 };
+std::atomic<int32> FSQLiteConnectionPool::MaxTotalConnections{ 0 };
+FCriticalSection FSQLiteConnectionPool::AllPoolsLock;
+TArray<FSQLiteConnectionPool*> FSQLiteConnectionPool::AllPools;
+
+//--------------------------------------------------------------------------------------------------------------
+
+FSQLiteConnection::FSQLiteConnection(sqlite3* InDb, int32 StatementCacheSize, FSQLiteStatementCacheCounters& StatementCacheCounters)
+	: Db(InDb)
+	, StatementCache(InDb, StatementCacheSize, StatementCacheCounters)
+	, LastUsedTime(FPlatformTime::Seconds())
+{
+	NumOpen++;
+}
+
+FSQLiteConnection::~FSQLiteConnection()
+{
+	// sqlite3_close fails while statements are left unfinalized
+	StatementCache.Empty();
+	if (Db)
+	{
+		sqlite3_close(Db);
+	}
+	NumOpen--;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+FSQLitePooledConnection::FSQLitePooledConnection(TSharedRef<FSQLiteConnectionPool, ESPMode::ThreadSafe> InPool, TUniquePtr<FSQLiteConnection>&& InConnection)
+	: Pool(InPool)
+	, Connection(MoveTemp(InConnection))
+{
+}
+
+FSQLitePooledConnection::FSQLitePooledConnection(TSharedRef<FSQLiteConnectionPool, ESPMode::ThreadSafe> InPool, TSharedRef<FSQLiteConnection, ESPMode::ThreadSafe> InThreadReader)
+	: Pool(InPool)
+	, ThreadReader(InThreadReader)
+{
+}
+
+FSQLitePooledConnection& FSQLitePooledConnection::operator=(FSQLitePooledConnection&& Other)
+{
+	if (this != &Other)
+	{
+		Release();
+		Pool = MoveTemp(Other.Pool);
+		Connection = MoveTemp(Other.Connection);
+		ThreadReader = MoveTemp(Other.ThreadReader);
+	}
+	return *this;
+}
+
+FSQLitePooledConnection::~FSQLitePooledConnection()
+{
+	Release();
+}
+
+void FSQLitePooledConnection::Release()
+{
+	if (Pool.IsValid() && Connection.IsValid())
+	{
+		Pool->Release(MoveTemp(Connection));
+	}
+	Pool.Reset();
+	Connection.Reset();
+	ThreadReader.Reset();
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+FSQLiteConnectionProfile FSQLiteConnectionProfile::ReadOnlyContent()
+{
+	FSQLiteConnectionProfile profile;
+	profile.ReadOnly = true;
+	profile.Synchronous = TEXT("OFF");
+	profile.CacheSizeKiB = 8192;
+	profile.MmapSizeBytes = 256 * 1024 * 1024;
+	profile.TempStore = TEXT("MEMORY");
+	return profile;
+}
+
+FSQLiteConnectionProfile FSQLiteConnectionProfile::SaveGame()
+{
+	FSQLiteConnectionProfile profile;
+	profile.JournalMode = TEXT("WAL");
+	profile.Synchronous = TEXT("FULL");
+	profile.CacheSizeKiB = 2048;
+	profile.TempStore = TEXT("MEMORY");
+	profile.BusyTimeoutMs = 2000;
+	return profile;
+}
+
+FSQLiteConnectionProfile FSQLiteConnectionProfile::Telemetry()
+{
+	FSQLiteConnectionProfile profile;
+	profile.JournalMode = TEXT("WAL");
+	profile.Synchronous = TEXT("OFF");
+	profile.CacheSizeKiB = 1024;
+	profile.TempStore = TEXT("MEMORY");
+	profile.BusyTimeoutMs = 5000;
+	return profile;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+/** Pragma values are pasted into the SQL, so only plain keywords are accepted */
+static bool IsPragmaKeyword(const FString& Value)
+{
+	for (const TCHAR c : Value)
+	{
+		if (!FChar::IsAlpha(c))
+		{
+			return false;
+		}
+	}
+	return !Value.IsEmpty();
+}
+
+static void AppendPragma(FString& Pragmas, const TCHAR* Name, const FString& Value, const FString& Filename)
+{
+	if (Value.IsEmpty())
+	{
+		return;
+	}
+	if (!IsPragmaKeyword(Value))
+	{
+		UE_LOG(LogDatabase, Warning, TEXT("SQLite: Ignoring invalid %s '%s' in the connection profile of '%s'"), Name, *Value, *Filename);
+		return;
+	}
+	Pragmas += FString::Printf(TEXT("PRAGMA %s=%s;"), Name, *Value);
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+FSQLiteConnectionPool::FSQLiteConnectionPool(const FString& InFilename, const FSQLiteConnectionPoolSettings& InSettings,
+	const FSQLiteConnectionProfile& InProfile)
+	: Filename(InFilename)
+	, Settings(InSettings)
+	, Profile(InProfile)
+{
+	if (Settings.PerThreadWalReaders)
+	{
+		// One dedicated writer, open from the start so the file is in WAL mode before any reader opens it
+		Settings.MaxConnections = 1;
+		Settings.MinConnections = 1;
+
+		if (!Profile.JournalMode.IsEmpty() && !Profile.JournalMode.Equals(TEXT("WAL"), ESearchCase::IgnoreCase))
+		{
+			UE_LOG(LogDatabase, Warning, TEXT("SQLite: PerThreadWalReaders overrides journal mode '%s' of '%s'"), *Profile.JournalMode, *Filename);
+		}
+		Profile.JournalMode = TEXT("WAL");
+	}
+	Settings.MaxConnections = FMath::Max(Settings.MaxConnections, 1);
+	Settings.MinConnections = FMath::Clamp(Settings.MinConnections, 0, Settings.MaxConnections);
+
+	// page_size has to come before journal_mode, it can't be changed anymore once the file is in WAL mode
+	if (!Profile.ReadOnly)
+	{
+		if (Profile.PageSize > 0)
+		{
+			WriterPragmas += FString::Printf(TEXT("PRAGMA page_size=%d;"), Profile.PageSize);
+		}
+		AppendPragma(WriterPragmas, TEXT("journal_mode"), Profile.JournalMode, Filename);
+	}
+	AppendPragma(ConnectionPragmas, TEXT("synchronous"), Profile.Synchronous, Filename);
+	if (Profile.CacheSizeKiB > 0)
+	{
+		// Negative values are KiB instead of pages
+		ConnectionPragmas += FString::Printf(TEXT("PRAGMA cache_size=-%d;"), Profile.CacheSizeKiB);
+	}
+	if (Profile.MmapSizeBytes >= 0)
+	{
+		ConnectionPragmas += FString::Printf(TEXT("PRAGMA mmap_size=%lld;"), Profile.MmapSizeBytes);
+	}
+	AppendPragma(ConnectionPragmas, TEXT("temp_store"), Profile.TempStore, Filename);
+
+	ConnectionReturnedEvent = FPlatformProcess::GetSynchEventFromPool(false);
+
+	FScopeLock lock(&AllPoolsLock);
+	AllPools.Add(this);
+}
+
+FSQLiteConnectionPool::~FSQLiteConnectionPool()
+{
+	{
+		// First thing, so MakeRoomForConnection() never sees a pool that's being torn down
+		FScopeLock lock(&AllPoolsLock);
+		AllPools.RemoveSingleSwap(this, false);
+	}
+	IdleConnections.Empty();
+	FPlatformProcess::ReturnSynchEventToPool(ConnectionReturnedEvent);
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+bool FSQLiteConnectionPool::Warmup()
+{
+	TArray<FSQLitePooledConnection> warmedUp;
+	while (warmedUp.Num() < FMath::Max(Settings.MinConnections, 1))
+	{
+		FSQLitePooledConnection connection = Acquire();
+		if (!connection.IsValid())
+		{
+			Validity.store(EValidity::Invalid);
+			return false;
+		}
+		warmedUp.Add(MoveTemp(connection));
+	}
+
+	// The first connection doubles as the validity check, so the file is opened only once.
+	// sqlite3_open_v2 alone doesn't touch the file, reading the schema version makes it read the header
+	const int32 result = sqlite3_exec(warmedUp[0].GetDb(), "PRAGMA schema_version", nullptr, nullptr, nullptr);
+	if (result != SQLITE_OK)
+	{
+		UE_LOG(LogDatabase, Error, TEXT("SQLite: '%s' is not a usable database, code: '%s' (%i)"), *Filename, UTF8_TO_TCHAR(sqlite3_errstr(result)), result);
+		Validity.store(EValidity::Invalid);
+		return false;
+	}
+	Validity.store(EValidity::Valid);
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+FSQLitePooledConnection FSQLiteConnectionPool::Acquire()
+{
+	const double deadline = FPlatformTime::Seconds() + FMath::Max(Settings.AcquireTimeoutSeconds, 0.0f);
+
+	for (;;)
+	{
+		bool openNew = false;
+		TArray<TUniquePtr<FSQLiteConnection>> closed;
+		{
+			FScopeLock lock(&Mutex);
+			if (bShutdown)
+			{
+				// Pass the wake-up on to the next waiter
+				ConnectionReturnedEvent->Trigger();
+				LOGSQLITE(Error, *FString::Printf(TEXT("Connection pool for '%s' is shut down."), *Filename));
+				return FSQLitePooledConnection();
+			}
+
+			// The thread's own open transaction comes first, whatever else is idle
+			TUniquePtr<FSQLiteConnection> inTransaction;
+			if (TransactionConnections.RemoveAndCopyValue(FPlatformTLS::GetCurrentThreadId(), inTransaction))
+			{
+				NumTransactionConnections.store(TransactionConnections.Num());
+				return FSQLitePooledConnection(AsShared(), MoveTemp(inTransaction));
+			}
+
+			while (IdleConnections.Num() > 0)
+			{
+				TUniquePtr<FSQLiteConnection> connection = IdleConnections.Pop(false);
+				if (!Settings.HealthCheck || IsHealthy(*connection, false))
+				{
+					return FSQLitePooledConnection(AsShared(), MoveTemp(connection));
+				}
+				if (PinnedConnection == connection.Get())
+				{
+					PinnedConnection = nullptr;
+				}
+				NumOpenConnections--;
+				closed.Add(MoveTemp(connection));
+			}
+
+			if (PinnedConnection == nullptr && NumOpenConnections < Settings.MaxConnections)
+			{
+				NumOpenConnections++;
+				openNew = true;
+			}
+		}
+		closed.Empty();
+
+		if (openNew)
+		{
+			MakeRoomForConnection();
+			TUniquePtr<FSQLiteConnection> connection = OpenConnection(false);
+			if (connection.IsValid())
+			{
+				return FSQLitePooledConnection(AsShared(), MoveTemp(connection));
+			}
+
+			{
+				FScopeLock lock(&Mutex);
+				NumOpenConnections--;
+			}
+			RequestRevalidation();
+			ConnectionReturnedEvent->Trigger();
+			return FSQLitePooledConnection();
+		}
+
+		const double remaining = deadline - FPlatformTime::Seconds();
+		if (remaining <= 0.0)
+		{
+			LOGSQLITE(Error, *FString::Printf(TEXT("Timed out waiting for a free connection to '%s' (%d in use)."), *Filename, Settings.MaxConnections));
+			return FSQLitePooledConnection();
+		}
+		ConnectionReturnedEvent->Wait(FTimespan::FromSeconds(remaining));
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+FSQLitePooledConnection FSQLiteConnectionPool::AcquireReader()
+{
+	if (!Settings.PerThreadWalReaders)
+	{
+		return Acquire();
+	}
+
+	const uint32 threadId = FPlatformTLS::GetCurrentThreadId();
+	if (NumTransactionConnections.load() > 0)
+	{
+		// Reads inside the thread's transaction have to see its uncommitted writes
+		FScopeLock lock(&Mutex);
+		if (TransactionConnections.Contains(threadId))
+		{
+			return Acquire();
+		}
+	}
+
+	{
+		FRWScopeLock lock(ThreadReadersLock, SLT_ReadOnly);
+		if (const TSharedPtr<FSQLiteConnection, ESPMode::ThreadSafe>* reader = ThreadReaders.Find(threadId))
+		{
+			// Only this thread touches its own reader's time while the lock is shared
+			(*reader)->LastUsedTime = FPlatformTime::Seconds();
+			return FSQLitePooledConnection(AsShared(), reader->ToSharedRef());
+		}
+	}
+
+	{
+		FScopeLock lock(&Mutex);
+		if (bShutdown || PinnedConnection != nullptr)
+		{
+			// A pinned (deserialized) connection is the only one that sees the data
+			return Acquire();
+		}
+	}
+
+	// Only this thread adds its own entry, so nobody else can have added it in the meantime
+	MakeRoomForConnection();
+	TUniquePtr<FSQLiteConnection> opened = OpenConnection(true);
+	if (!opened.IsValid())
+	{
+		RequestRevalidation();
+		return FSQLitePooledConnection();
+	}
+
+	TSharedRef<FSQLiteConnection, ESPMode::ThreadSafe> reader = MakeShareable(opened.Release());
+	{
+		FRWScopeLock lock(ThreadReadersLock, SLT_Write);
+		ThreadReaders.Add(threadId, reader);
+	}
+	return FSQLitePooledConnection(AsShared(), reader);
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+void FSQLiteConnectionPool::Release(TUniquePtr<FSQLiteConnection>&& Connection)
+{
+	TArray<TUniquePtr<FSQLiteConnection>> closed;
+	{
+		FScopeLock lock(&Mutex);
+		bool keep = !bShutdown
+			&& (PinnedConnection == nullptr || PinnedConnection == Connection.Get())
+			&& (!Settings.HealthCheck || IsHealthy(*Connection, true));
+
+		const double now = FPlatformTime::Seconds();
+		const uint32 threadId = FPlatformTLS::GetCurrentThreadId();
+		const bool inTransaction = keep && sqlite3_get_autocommit(Connection->Db) == 0;
+		if (inTransaction && TransactionConnections.Contains(threadId))
+		{
+			// Only one connection per thread is kept for its transaction, the other one's work can't be continued
+			LOGSQLITE(Error, *FString::Printf(TEXT("A second connection to '%s' was returned inside a transaction by the same thread, rolling that transaction back."), *Filename));
+			sqlite3_exec(Connection->Db, "ROLLBACK", nullptr, nullptr, nullptr);
+			keep = sqlite3_get_autocommit(Connection->Db) != 0;
+		}
+
+		if (keep && inTransaction && !TransactionConnections.Contains(threadId))
+		{
+			// Kept for the next call of the same thread, which continues (and ends) the transaction
+			Connection->LastUsedTime = now;
+			TransactionConnections.Add(threadId, MoveTemp(Connection));
+			NumTransactionConnections.store(TransactionConnections.Num());
+		}
+		else if (keep)
+		{
+			Connection->LastUsedTime = now;
+			IdleConnections.Add(MoveTemp(Connection));
+		}
+		else
+		{
+			if (PinnedConnection == Connection.Get())
+			{
+				PinnedConnection = nullptr;
+			}
+			NumOpenConnections--;
+			closed.Add(MoveTemp(Connection));
+		}
+
+		PruneIdleConnections_Locked(now, closed);
+	}
+	closed.Empty();
+
+	ConnectionReturnedEvent->Trigger();
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+void FSQLiteConnectionPool::Shutdown()
+{
+	TArray<TUniquePtr<FSQLiteConnection>> closed;
+	{
+		FScopeLock lock(&Mutex);
+		bShutdown = true;
+		PinnedConnection = nullptr;
+		NumOpenConnections -= IdleConnections.Num() + TransactionConnections.Num();
+		closed = MoveTemp(IdleConnections);
+		for (TPair<uint32, TUniquePtr<FSQLiteConnection>>& transaction : TransactionConnections)
+		{
+			closed.Add(MoveTemp(transaction.Value));
+		}
+		TransactionConnections.Empty();
+		NumTransactionConnections.store(0);
+	}
+	closed.Empty();
+
+	// Readers still in use are closed by their last borrower
+	{
+		FRWScopeLock lock(ThreadReadersLock, SLT_Write);
+		ThreadReaders.Empty();
+	}
+
+#if WITH_EDITOR
+	StopWatchingFile();
+#endif
+
+	ConnectionReturnedEvent->Trigger();
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+void FSQLiteConnectionPool::PruneIdleConnections()
+{
+	const double now = FPlatformTime::Seconds();
+	TArray<TUniquePtr<FSQLiteConnection>> closed;
+	{
+		FScopeLock lock(&Mutex);
+		PruneIdleConnections_Locked(now, closed);
+	}
+	closed.Empty();
+
+	if (!Settings.PerThreadWalReaders || Settings.IdleTimeoutSeconds < 0.0f)
+	{
+		return;
+	}
+
+	// Readers nobody borrows right now are only referenced by the map, their threads open new ones when needed
+	TArray<TSharedPtr<FSQLiteConnection, ESPMode::ThreadSafe>> closedReaders;
+	{
+		FRWScopeLock lock(ThreadReadersLock, SLT_Write);
+		for (auto it = ThreadReaders.CreateIterator(); it; ++it)
+		{
+			if (it->Value.GetSharedReferenceCount() == 1 && now - it->Value->LastUsedTime >= Settings.IdleTimeoutSeconds)
+			{
+				closedReaders.Add(MoveTemp(it->Value));
+				it.RemoveCurrent();
+			}
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+void FSQLiteConnectionPool::SetMaxTotalConnections(int32 MaxConnections)
+{
+	MaxTotalConnections.store(FMath::Max(MaxConnections, 0));
+}
+
+void FSQLiteConnectionPool::MakeRoomForConnection()
+{
+	const int32 maxConnections = MaxTotalConnections.load();
+	if (maxConnections <= 0 || FSQLiteConnection::GetNumOpen() < maxConnections)
+	{
+		return;
+	}
+
+	FScopeLock lock(&AllPoolsLock);
+	FSQLiteConnectionPool* oldestPool = nullptr;
+	double oldestTime = 0.0;
+	for (FSQLiteConnectionPool* pool : AllPools)
+	{
+		double lastUsedTime;
+		if (pool->GetOldestClosableIdleTime(lastUsedTime) && (!oldestPool || lastUsedTime < oldestTime))
+		{
+			oldestPool = pool;
+			oldestTime = lastUsedTime;
+		}
+	}
+
+	if (oldestPool)
+	{
+		oldestPool->CloseOldestIdleConnection();
+	}
+	else
+	{
+		// Everything open is in use or kept open on purpose, go over the cap rather than fail the query
+		LOGSQLITE(Verbose, *FString::Printf(TEXT("%d connections open, nothing idle to close."), FSQLiteConnection::GetNumOpen()));
+	}
+}
+
+bool FSQLiteConnectionPool::GetOldestClosableIdleTime(double& OutLastUsedTime) const
+{
+	FScopeLock lock(&Mutex);
+	if (IdleConnections.Num() == 0 || NumOpenConnections <= Settings.MinConnections || IdleConnections[0].Get() == PinnedConnection)
+	{
+		return false;
+	}
+	OutLastUsedTime = IdleConnections[0]->LastUsedTime;
+	return true;
+}
+
+void FSQLiteConnectionPool::CloseOldestIdleConnection()
+{
+	TUniquePtr<FSQLiteConnection> closed;
+	{
+		FScopeLock lock(&Mutex);
+		if (IdleConnections.Num() == 0 || NumOpenConnections <= Settings.MinConnections || IdleConnections[0].Get() == PinnedConnection)
+		{
+			return;
+		}
+		closed = MoveTemp(IdleConnections[0]);
+		IdleConnections.RemoveAt(0, 1, false);
+		NumOpenConnections--;
+	}
+	LOGSQLITE(Verbose, *FString::Printf(TEXT("Closed the least recently used connection to '%s' to stay below %d open connections."), *Filename, MaxTotalConnections.load()));
+}
+
+void FSQLiteConnectionPool::PruneIdleConnections_Locked(double Now, TArray<TUniquePtr<FSQLiteConnection>>& OutClosed)
+{
+	if (Settings.IdleTimeoutSeconds < 0.0f)
+	{
+		return;
+	}
+
+	// Idle connections are ordered by the time they were returned, oldest first
+	while (IdleConnections.Num() > 0 && NumOpenConnections > Settings.MinConnections)
+	{
+		const TUniquePtr<FSQLiteConnection>& oldest = IdleConnections[0];
+		if (oldest.Get() == PinnedConnection || Now - oldest->LastUsedTime < Settings.IdleTimeoutSeconds)
+		{
+			break;
+		}
+		OutClosed.Add(MoveTemp(IdleConnections[0]));
+		IdleConnections.RemoveAt(0, 1, false);
+		NumOpenConnections--;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+void FSQLiteConnectionPool::PinConnection(const FSQLitePooledConnection& Connection)
+{
+	TArray<TUniquePtr<FSQLiteConnection>> closed;
+	{
+		FScopeLock lock(&Mutex);
+		PinnedConnection = Connection.GetConnection();
+		NumOpenConnections -= IdleConnections.Num() + TransactionConnections.Num();
+		closed = MoveTemp(IdleConnections);
+		for (TPair<uint32, TUniquePtr<FSQLiteConnection>>& transaction : TransactionConnections)
+		{
+			closed.Add(MoveTemp(transaction.Value));
+		}
+		TransactionConnections.Empty();
+		NumTransactionConnections.store(0);
+	}
+
+	{
+		FRWScopeLock lock(ThreadReadersLock, SLT_Write);
+		ThreadReaders.Empty();
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+bool FSQLiteConnectionPool::IsValidDatabase()
+{
+	EValidity validity = Validity.load();
+	if (validity == EValidity::Unchecked)
+	{
+		// Concurrent callers may check at the same time, they come to the same answer
+		validity = CheckFile() ? EValidity::Valid : EValidity::Invalid;
+		EValidity expected = EValidity::Unchecked;
+		Validity.compare_exchange_strong(expected, validity);
+	}
+	return validity == EValidity::Valid;
+}
+
+void FSQLiteConnectionPool::RequestRevalidation()
+{
+	Validity.store(EValidity::Unchecked);
+}
+
+bool FSQLiteConnectionPool::CheckFile() const
+{
+	{
+		FScopeLock lock(&Mutex);
+		if (PinnedConnection != nullptr)
+		{
+			// Queries only see the deserialized copy from now on, the file doesn't matter anymore
+			return true;
+		}
+	}
+
+	if (!IFileManager::Get().FileExists(*Filename))
+	{
+		if (Settings.CreateIfMissing)
+		{
+			// Created by the first connection
+			return true;
+		}
+		LOGSQLITE(Error, *FString::Printf(TEXT("Database file '%s' does not exist."), *Filename));
+		return false;
+	}
+
+	// sqlite3_open_v2 alone doesn't touch the file, reading the schema version makes it read the header
+	sqlite3* db = nullptr;
+	int32 result = sqlite3_open_v2(TCHAR_TO_UTF8(*Filename), &db, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr);
+	if (result == SQLITE_OK)
+	{
+		result = sqlite3_exec(db, "PRAGMA schema_version", nullptr, nullptr, nullptr);
+	}
+	if (result != SQLITE_OK)
+	{
+		UE_LOG(LogDatabase, Error, TEXT("SQLite: '%s' is not a usable database, code: '%s' (%i)"), *Filename, UTF8_TO_TCHAR(sqlite3_errstr(result)), result);
+	}
+	sqlite3_close(db);
+	return result == SQLITE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+void FSQLiteConnectionPool::OnFileChanged()
+{
+	TArray<TUniquePtr<FSQLiteConnection>> closed;
+	{
+		FScopeLock lock(&Mutex);
+		if (PinnedConnection != nullptr)
+		{
+			return;
+		}
+		NumOpenConnections -= IdleConnections.Num();
+		closed = MoveTemp(IdleConnections);
+	}
+	closed.Empty();
+
+	{
+		FRWScopeLock lock(ThreadReadersLock, SLT_Write);
+		ThreadReaders.Empty();
+	}
+
+	RequestRevalidation();
+	LOGSQLITE(Verbose, *FString::Printf(TEXT("Database file '%s' changed on disk."), *Filename));
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+#if WITH_EDITOR
+void FSQLiteConnectionPool::StartWatchingFile()
+{
+	// The directory watcher may only be used on the game thread
+	if (!IsInGameThread())
+	{
+		TWeakPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe> weakThis = AsShared();
+		AsyncTask(ENamedThreads::GameThread, [weakThis]()
+		{
+			if (TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe> pool = weakThis.Pin())
+			{
+				pool->StartWatchingFile();
+			}
+		});
+		return;
+	}
+
+	FDirectoryWatcherModule& directoryWatcherModule = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+	IDirectoryWatcher* directoryWatcher = directoryWatcherModule.Get();
+	if (!directoryWatcher)
+	{
+		return;
+	}
+
+	FScopeLock lock(&Mutex);
+	if (bShutdown || FileWatcherHandle.IsValid())
+	{
+		return;
+	}
+
+	const FString fullFilename = FPaths::ConvertRelativePathToFull(Filename);
+	WatchedDirectory = FPaths::GetPath(fullFilename);
+
+	TWeakPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe> weakThis = AsShared();
+	directoryWatcher->RegisterDirectoryChangedCallback_Handle(WatchedDirectory,
+		IDirectoryWatcher::FDirectoryChanged::CreateLambda([weakThis, fullFilename](const TArray<FFileChangeData>& Changes)
+		{
+			TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe> pool = weakThis.Pin();
+			if (!pool.IsValid())
+			{
+				return;
+			}
+			for (const FFileChangeData& change : Changes)
+			{
+				if (FPaths::IsSamePath(FPaths::ConvertRelativePathToFull(change.Filename), fullFilename))
+				{
+					pool->OnFileChanged();
+					return;
+				}
+			}
+		}),
+		FileWatcherHandle);
+}
+
+void FSQLiteConnectionPool::StopWatchingFile()
+{
+	FString directory;
+	FDelegateHandle handle;
+	{
+		FScopeLock lock(&Mutex);
+		directory = MoveTemp(WatchedDirectory);
+		handle = FileWatcherHandle;
+		FileWatcherHandle.Reset();
+	}
+	if (!handle.IsValid())
+	{
+		return;
+	}
+
+	auto unregister = [directory, handle]()
+	{
+		if (FDirectoryWatcherModule* directoryWatcherModule = FModuleManager::GetModulePtr<FDirectoryWatcherModule>(TEXT("DirectoryWatcher")))
+		{
+			if (IDirectoryWatcher* directoryWatcher = directoryWatcherModule->Get())
+			{
+				directoryWatcher->UnregisterDirectoryChangedCallback_Handle(directory, handle);
+			}
+		}
+	};
+
+	// The pool may be gone by the time the game thread gets to it, so the task doesn't refer to it
+	if (IsInGameThread())
+	{
+		unregister();
+	}
+	else
+	{
+		AsyncTask(ENamedThreads::GameThread, MoveTemp(unregister));
+	}
+}
+#endif
+
+//--------------------------------------------------------------------------------------------------------------
+
+int32 FSQLiteConnectionPool::GetNumOpenConnections() const
+{
+	FScopeLock lock(&Mutex);
+	return NumOpenConnections;
+}
+
+FSQLiteStatementCacheStats FSQLiteConnectionPool::GetStatementCacheStats() const
+{
+	FSQLiteStatementCacheStats stats;
+	stats.Hits = StatementCacheCounters.Hits.load();
+	stats.Misses = StatementCacheCounters.Misses.load();
+	stats.Evictions = StatementCacheCounters.Evictions.load();
+	stats.Uncached = StatementCacheCounters.Uncached.load();
+	return stats;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+TUniquePtr<FSQLiteConnection> FSQLiteConnectionPool::OpenConnection(bool bReadOnly)
+{
+	// Borrowed connections are only ever used by one thread at a time, so SQLite's own mutex is not needed
+	sqlite3* db = nullptr;
+	const bool readOnly = bReadOnly || Profile.ReadOnly;
+	// Without CreateIfMissing a missing file fails here instead of silently turning into an empty database
+	const int32 createFlag = Settings.CreateIfMissing ? SQLITE_OPEN_CREATE : 0;
+	const int32 flags = (readOnly ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE | createFlag) | SQLITE_OPEN_NOMUTEX;
+	const int32 result = sqlite3_open_v2(TCHAR_TO_UTF8(*Filename), &db, flags, nullptr);
+	if (result != SQLITE_OK)
+	{
+		UE_LOG(LogDatabase, Error, TEXT("SQLite: Could not open '%s', code: '%s' (%i)"), *Filename, UTF8_TO_TCHAR(sqlite3_errstr(result)), result);
+		sqlite3_close(db);
+		return nullptr;
+	}
+
+	if (Profile.BusyTimeoutMs > 0)
+	{
+		sqlite3_busy_timeout(db, Profile.BusyTimeoutMs);
+	}
+
+	// A pragma that can't be applied leaves the connection usable, just not tuned
+	const FString pragmas = readOnly ? ConnectionPragmas : WriterPragmas + ConnectionPragmas;
+	if (!pragmas.IsEmpty())
+	{
+		char* errorMessage = nullptr;
+		if (sqlite3_exec(db, TCHAR_TO_UTF8(*pragmas), nullptr, nullptr, &errorMessage) != SQLITE_OK)
+		{
+			UE_LOG(LogDatabase, Warning, TEXT("SQLite: Could not apply the connection profile to '%s': %s"), *Filename, UTF8_TO_TCHAR(errorMessage));
+			sqlite3_free(errorMessage);
+		}
+	}
+
+	LOGSQLITE(Verbose, *FString::Printf(TEXT("Opened pooled connection to '%s'."), *Filename));
+	return MakeUnique<FSQLiteConnection>(db, Settings.StatementCacheSize, StatementCacheCounters);
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+bool FSQLiteConnectionPool::IsHealthy(FSQLiteConnection& Connection, bool bReturning)
+{
+	if (bReturning)
+	{
+		// Errors that leave the connection (or the file behind it) unusable
+		switch (sqlite3_errcode(Connection.Db) & 0xff)
+		{
+		case SQLITE_CORRUPT:
+		case SQLITE_NOTADB:
+		case SQLITE_IOERR:
+		case SQLITE_CANTOPEN:
+			RequestRevalidation();
+			return false;
+		default:
+			return true;
+		}
+	}
+
+	// Connections returned inside a transaction stay with their thread (see Release()), an idle one in a transaction
+	// would hand it over to somebody else. It's not rolled back here, just not handed out
+	if (sqlite3_get_autocommit(Connection.Db) == 0)
+	{
+		LOGSQLITE(Warning, *FString::Printf(TEXT("Closing an idle connection to '%s' that is inside a transaction."), *Filename));
+		return false;
+	}
+	return true;
+}
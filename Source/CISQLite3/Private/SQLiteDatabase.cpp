@@ -1,10 +1,12 @@
 #include "SQLiteDatabase.h"
 #include "CISQLite3PrivatePCH.h"
+#include "HAL/FileManager.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
 
 #define LOGSQLITE(verbosity, text) UE_LOG(LogDatabase, verbosity, TEXT("SQLite: %s"), text)
 
-TMap<FString, FString> USQLiteDatabase::Databases;
-TMap<FString, sqlite3*> USQLiteDatabase::SQLite3Databases;
+FSQLiteDatabaseRegistry USQLiteDatabase::Databases;
 
 //--------------------------------------------------------------------------------------------------------------
 
@@ -19,11 +21,11 @@ bool USQLiteDatabase::CreateDatabase(const FString& Filename, bool RelativeToPro
 {
 	const FString actualFilename = RelativeToProjectContentDirectory ? FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir()) + Filename : Filename;
 
-    sqlite3* db;
-    int res = sqlite3_open(TCHAR_TO_ANSI(*actualFilename), &db);
+    sqlite3* db = nullptr;
+    int res = sqlite3_open_v2(TCHAR_TO_UTF8(*actualFilename), &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr);
+    sqlite3_close(db);
     if (res == SQLITE_OK)
     {
-        sqlite3_close(db);
         return true;
     }
     else {
@@ -35,122 +37,201 @@ bool USQLiteDatabase::CreateDatabase(const FString& Filename, bool RelativeToPro
 
 //--------------------------------------------------------------------------------------------------------------
 
-bool USQLiteDatabase::RegisterDatabase(const FString& Name, const FString& Filename, bool RelativeToProjectContentDirectory, bool KeepOpen)
+bool USQLiteDatabase::RegisterDatabase(const FString& Name, const FString& Filename, bool RelativeToProjectContentDirectory, bool KeepOpen, bool LazyOpen)
+{
+	FSQLiteConnectionPoolSettings poolSettings;
+	if (KeepOpen)
+	{
+		// Same as before pooling: one connection for everything
+		poolSettings.MinConnections = 1;
+		poolSettings.MaxConnections = 1;
+	}
+	poolSettings.LazyOpen = LazyOpen && !KeepOpen;
+	return RegisterDatabaseWithSettings(Name, Filename, RelativeToProjectContentDirectory, poolSettings, FSQLiteConnectionProfile()).IsSet();
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+FSQLiteDatabaseHandle USQLiteDatabase::RegisterDatabaseWithSettings(const FString& Name, const FString& Filename, bool RelativeToProjectContentDirectory,
+	const FSQLiteConnectionPoolSettings& PoolSettings, const FSQLiteConnectionProfile& Profile)
 {
 	const FString actualFilename = RelativeToProjectContentDirectory ? FPaths::ProjectContentDir() + Filename : Filename;
 
-	if (!IsValidDatabase(actualFilename, true))
+	const FSQLiteDatabaseHandle existing = Databases.Find(Name);
+	if (existing.IsSet())
+	{
+		FString message = "Database '" + actualFilename + "' is already registered, skipping.";
+		LOGSQLITE(Warning, *message);
+		return existing;
+	}
+
+	// Opening the pool's first connection is the validity check, the file is opened once and the
+	// connection is kept for the first query. Afterwards the pool remembers the answer
+	TSharedRef<FSQLiteConnectionPool, ESPMode::ThreadSafe> pool = MakeShared<FSQLiteConnectionPool, ESPMode::ThreadSafe>(actualFilename, PoolSettings, Profile);
+	const bool lazy = PoolSettings.LazyOpen && pool->GetSettings().MinConnections == 0;
+	if (lazy ? !PoolSettings.CreateIfMissing && !IFileManager::Get().FileExists(*actualFilename) : !pool->Warmup())
 	{
 		FString message = "Unable to add database '" + actualFilename + "', it is not valid (problems opening it)!";
 		LOGSQLITE(Error, *message);
-		return false;
+		pool->Shutdown();
+		return FSQLiteDatabaseHandle();
 	}
 
-	if (!IsDatabaseRegistered(Name))
+	const FSQLiteDatabaseHandle handle = Databases.Add(Name, pool);
+	if (!handle.IsSet())
 	{
-        Databases.Add(Name, actualFilename);
-        FString successMessage = "Registered SQLite database '" + actualFilename + "' successfully.";
-        LOGSQLITE(Verbose, *successMessage);
-    }
-    else {
+		// Another thread registered the same name while this pool was opening
+		pool->Shutdown();
 		FString message = "Database '" + actualFilename + "' is already registered, skipping.";
 		LOGSQLITE(Warning, *message);
-    }
+		return Databases.Find(Name);
+	}
 
-    if (KeepOpen) {
-        sqlite3* db;
-        if (sqlite3_open(TCHAR_TO_ANSI(*actualFilename), &db) == SQLITE_OK)
-        {
-            SQLite3Databases.Add(Name, db);
-        }
-    }
+#if WITH_EDITOR
+	pool->StartWatchingFile();
+#endif
 
-	return true;
+	FString successMessage = "Registered SQLite database '" + actualFilename + "' successfully.";
+	LOGSQLITE(Verbose, *successMessage);
+
+	return handle;
+
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+void USQLiteDatabase::RegisterDatabasesAsync(const TArray<FSQLiteDatabaseRegistration>& Registrations, FSQLiteDatabasesRegisteredDelegate OnRegistered)
+{
+	RegisterDatabasesAsync(Registrations, [OnRegistered](const TArray<FSQLiteDatabaseHandle>& Handles)
+	{
+		OnRegistered.ExecuteIfBound(Handles);
+	});
+}
+
+void USQLiteDatabase::RegisterDatabasesAsync(const TArray<FSQLiteDatabaseRegistration>& Registrations,
+	TFunction<void(const TArray<FSQLiteDatabaseHandle>&)> OnRegistered)
+{
+	Async(EAsyncExecution::ThreadPool, [Registrations, OnRegistered = MoveTemp(OnRegistered)]()
+	{
+		// Each registration only locks its own name shard and slot, so the files open in parallel
+		TArray<FSQLiteDatabaseHandle> handles;
+		handles.SetNum(Registrations.Num());
+		ParallelFor(Registrations.Num(), [&Registrations, &handles](int32 Index)
+		{
+			const FSQLiteDatabaseRegistration& registration = Registrations[Index];
+			handles[Index] = RegisterDatabaseWithSettings(registration.Name, registration.Filename, registration.RelativeToGameContentDirectory,
+				registration.PoolSettings, registration.Profile);
+		});
 
+		AsyncTask(ENamedThreads::GameThread, [OnRegistered, handles = MoveTemp(handles)]()
+		{
+			if (OnRegistered)
+			{
+				OnRegistered(handles);
+			}
+		});
+	});
 }
 
 //--------------------------------------------------------------------------------------------------------------
 
 void USQLiteDatabase::UnregisterDatabase(const FString& Name) {
-    /* Remove in case KeepOpen flag was set to true */
-    if (SQLite3Databases.Contains(Name)) {
-        sqlite3_close(SQLite3Databases[Name]);
-        SQLite3Databases.Remove(Name);
+    UnregisterDatabase(Databases.Find(Name));
+}
+
+void USQLiteDatabase::UnregisterDatabase(FSQLiteDatabaseHandle Database) {
+    TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe> pool = Databases.Remove(Database);
+    if (pool.IsValid()) {
+        pool->Shutdown();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+void USQLiteDatabase::UnregisterAllDatabases() {
+    for (const TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe>& pool : Databases.RemoveAll()) {
+        pool->Shutdown();
     }
-    Databases.Remove(Name);
 }
 
 //--------------------------------------------------------------------------------------------------------------
 TArray<uint8> USQLiteDatabase::Dump(const FString& DatabaseName) {
-    sqlite3* Db;
-    const bool keepOpen = SQLite3Databases.Contains(DatabaseName);
-    if (keepOpen) {
-        Db = SQLite3Databases[DatabaseName];
-    } else {
-        const FString* databaseName = Databases.Find(DatabaseName);
-        if (!databaseName) {
-            LOGSQLITE(Error, TEXT("DB not registered."));
-            return {};
-        }
+    return Dump(Databases.Find(DatabaseName));
+}
 
-        const int err = sqlite3_open(TCHAR_TO_ANSI(**databaseName), &Db);
-        if (err != SQLITE_OK) {
-            const char* msg = sqlite3_errmsg(Db);
-            if(msg) {
-                UE_LOG(LogDatabase, Error, TEXT("Error ocurred during serialization, code: '%s' (%i), message: '%s'"), sqlite3_errstr(err), err, sqlite3_errmsg(Db));
-            } else {
-                UE_LOG(LogDatabase, Error, TEXT("Error ocurred during serialization, code: %s"), sqlite3_errstr(err));
-            }
-            return {};
-        }
+TArray<uint8> USQLiteDatabase::Dump(FSQLiteDatabaseHandle Database) {
+    FSQLitePooledConnection connection = AcquireConnection(Database);
+    if (!connection.IsValid()) {
+        return {};
     }
+    sqlite3* Db = connection.GetDb();
 
     int64 size;
     uint8* ptr = sqlite3_serialize(Db, "main", &size, 0);
     const int err = sqlite3_errcode(Db);
-    if (err != SQLITE_OK) {
+    if (err != SQLITE_OK || !ptr) {
         const char* msg = sqlite3_errmsg(Db);
         if(msg) {
-            UE_LOG(LogDatabase, Error, TEXT("Error ocurred during serialization, code: '%s' (%i), message: '%s'"), sqlite3_errstr(err), err, sqlite3_errmsg(Db));
+            UE_LOG(LogDatabase, Error, TEXT("Error ocurred during serialization, code: '%s' (%i), message: '%s'"), UTF8_TO_TCHAR(sqlite3_errstr(err)), err, UTF8_TO_TCHAR(msg));
         } else {
-            UE_LOG(LogDatabase, Error, TEXT("Error ocurred during serialization, code: %s"), sqlite3_errstr(err));
+            UE_LOG(LogDatabase, Error, TEXT("Error ocurred during serialization, code: %s"), UTF8_TO_TCHAR(sqlite3_errstr(err)));
         }
         return {};
     }
-    return TArray<uint8>(ptr, size);
+    TArray<uint8> data(ptr, size);
+    sqlite3_free(ptr);
+    return data;
 }
 
 bool USQLiteDatabase::Restore(const FString& DatabaseName, const TArray<uint8>& data) {
-    sqlite3* Db;
-    const bool keepOpen = SQLite3Databases.Contains(DatabaseName);
-    if (keepOpen) {
-        Db = SQLite3Databases[DatabaseName];
-    } else {
-        const FString* databaseName = Databases.Find(DatabaseName);
-        if (!databaseName) {
-            LOGSQLITE(Error, TEXT("DB not registered."));
-            return false;
-        }
+    return Restore(Databases.Find(DatabaseName), data);
+}
+
+bool USQLiteDatabase::Restore(FSQLiteDatabaseHandle Database, const TArray<uint8>& data) {
+    TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe> pool = Databases.GetPool(Database);
+    FSQLitePooledConnection connection = AcquireConnection(Database);
+    if (!connection.IsValid()) {
+        return false;
+    }
+    sqlite3* Db = connection.GetDb();
 
-        sqlite3_open(TCHAR_TO_ANSI(**databaseName), &Db);
+    /* The connection outlives the caller's array, so hand SQLite its own copy */
+    uint8* copy = static_cast<uint8*>(sqlite3_malloc64(data.Num()));
+    if (!copy && data.Num() > 0) {
+        LOGSQLITE(Error, TEXT("Out of memory during deserialization."));
+        return false;
     }
+    FMemory::Memcpy(copy, data.GetData(), data.Num());
 
-    const int err = sqlite3_deserialize(Db, "main", 
-        const_cast<unsigned char*>(data.GetData()), data.Num(), data.Num(), SQLITE_DESERIALIZE_READONLY);
+    const int err = sqlite3_deserialize(Db, "main", copy, data.Num(), data.Num(),
+        SQLITE_DESERIALIZE_READONLY | SQLITE_DESERIALIZE_FREEONCLOSE);
     if (err != SQLITE_OK) {
         const char* msg = sqlite3_errmsg(Db);
         if(msg) {
-            UE_LOG(LogDatabase, Error, TEXT("Error ocurred during serialization, code: '%s' (%i), message: '%s'"), sqlite3_errstr(err), err, sqlite3_errmsg(Db));
+            UE_LOG(LogDatabase, Error, TEXT("Error ocurred during serialization, code: '%s' (%i), message: '%s'"), UTF8_TO_TCHAR(sqlite3_errstr(err)), err, UTF8_TO_TCHAR(msg));
         } else {
-            UE_LOG(LogDatabase, Error, TEXT("Error ocurred during serialization, code: %s"), sqlite3_errstr(err));
+            UE_LOG(LogDatabase, Error, TEXT("Error ocurred during serialization, code: %s"), UTF8_TO_TCHAR(sqlite3_errstr(err)));
         }
         return false;
     }
+
+    /* Only this connection sees the restored data, keep using it for every query from now on */
+    pool->PinConnection(connection);
     return true;
 }
 //--------------------------------------------------------------------------------------------------------------
 
 bool USQLiteDatabase::GetDataIntoObject(const FString& DatabaseName, const FString& Query, UObject* ObjectToPopulate)
+{
+	return GetDataIntoObject(Databases.Find(DatabaseName), Query, ObjectToPopulate);
+}
+
+bool USQLiteDatabase::GetDataIntoObjectByHandle(FSQLiteDatabaseHandle Database, const FString& Query, UObject* ObjectToPopulate)
+{
+	return GetDataIntoObject(Database, Query, ObjectToPopulate);
+}
+
+bool USQLiteDatabase::GetDataIntoObject(FSQLiteDatabaseHandle Database, const FString& Query, UObject* ObjectToPopulate)
 {
 	//////////////////////////////////////////////////////////////////////////
 	// Check input validness.
@@ -166,16 +247,10 @@ bool USQLiteDatabase::GetDataIntoObject(const FString& DatabaseName, const FStri
 	// Validate the database
 	//////////////////////////////////////////////////////////////////////////
 
-	if (!IsDatabaseRegistered(DatabaseName) ||
-		!IsValidDatabase(Databases[DatabaseName], false))
-	{
-		LOGSQLITE(Error, *FString::Printf(TEXT("Unable to get data into object, invalid database '%s'"), *DatabaseName));
-		return false;
-	}
-
-	if (!CanOpenDatabase(Databases[DatabaseName]))
+	TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe> pool = Databases.GetPool(Database);
+	if (!pool.IsValid() || !pool->IsValidDatabase())
 	{
-		LOGSQLITE(Error, *FString::Printf(TEXT("Unable to open database '%s'"), *DatabaseName));
+		LOGSQLITE(Error, *FString::Printf(TEXT("Unable to get data into object, invalid database '%s'"), *Databases.GetName(Database)));
 		return false;
 	}
 
@@ -183,11 +258,11 @@ bool USQLiteDatabase::GetDataIntoObject(const FString& DatabaseName, const FStri
 	// Get the results
 	//////////////////////////////////////////////////////////////////////////
 
-	TUniquePtr<SQLiteQueryResult> queryResult = RunQueryAndGetResults(DatabaseName, Query);
+	TUniquePtr<SQLiteQueryResult> queryResult = RunQueryAndGetResults(Database, Query);
 
 	if (queryResult->Success && queryResult->Results.Num() > 0)
 	{
-		AssignResultsToObjectProperties(queryResult->Results[0], ObjectToPopulate);
+		AssignResultsToObjectProperties(queryResult->Results[0], queryResult->Columns, ObjectToPopulate);
 		return true;
 	}
 	else if (!queryResult->Success)
@@ -235,8 +310,9 @@ bool USQLiteDatabase::GetDataIntoObjectBP(const FSQLiteDatabaseReference& DataSo
 	// Validate the database
 	//////////////////////////////////////////////////////////////////////////
 
-	if (!IsDatabaseRegistered(DataSource.DatabaseName) ||
-		!IsValidDatabase(Databases[DataSource.DatabaseName], true))
+	const FSQLiteDatabaseHandle database = Databases.Find(DataSource.DatabaseName);
+	TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe> pool = Databases.GetPool(database);
+	if (!pool.IsValid() || !pool->IsValidDatabase())
 	{
 		LOGSQLITE(Error, TEXT("Unable to get data to object, database validation failed!"));
 		return false;
@@ -249,11 +325,11 @@ bool USQLiteDatabase::GetDataIntoObjectBP(const FSQLiteDatabaseReference& DataSo
 
 	FString constructedQuery = ConstructQuery(DataSource.Tables, Fields, Query, 1, 0);
 
-	TUniquePtr<SQLiteQueryResult> queryResult = RunQueryAndGetResults(DataSource.DatabaseName, constructedQuery);
+	TUniquePtr<SQLiteQueryResult> queryResult = RunQueryAndGetResults(database, constructedQuery);
 
 	if (queryResult->Success && queryResult->Results.Num() > 0)
 	{
-		AssignResultsToObjectProperties(queryResult->Results[0], ObjectToPopulate);
+		AssignResultsToObjectProperties(queryResult->Results[0], queryResult->Columns, ObjectToPopulate);
 		return true;
 	}
 	else if (!queryResult->Success)
@@ -273,25 +349,317 @@ bool USQLiteDatabase::GetDataIntoObjectBP(const FSQLiteDatabaseReference& DataSo
 
 //--------------------------------------------------------------------------------------------------------------
 
-TMap<FString, FProperty*> USQLiteDatabase::CollectProperties(UObject* SourceObject)
+int32 USQLiteDatabase::GetDataIntoObjects(const FString& DatabaseName, const FString& Query, const TArray<UObject*>& ObjectsToPopulate)
+{
+	return GetDataIntoObjects(Databases.Find(DatabaseName), Query, ObjectsToPopulate);
+}
+
+int32 USQLiteDatabase::GetDataIntoObjects(FSQLiteDatabaseHandle Database, const FString& Query, const TArray<UObject*>& ObjectsToPopulate)
+{
+	LOGSQLITE(Verbose, *Query);
+
+	FSQLiteRowCursor cursor;
+	if (ObjectsToPopulate.Num() == 0 || !cursor.Open(Database, Query))
+	{
+		return 0;
+	}
+
+	// Objects of the same class share a plan, it's only looked up again when the class changes
+	const FSQLiteColumnsPtr columns = cursor.GetColumns();
+	TSharedPtr<const FSQLiteBindingPlan, ESPMode::ThreadSafe> plan;
+	const UClass* planClass = nullptr;
+
+	int32 rowIndex = 0;
+	int32 populated = 0;
+	for (const FSQLiteRowCursor& row : cursor)
+	{
+		UObject* object = ObjectsToPopulate[rowIndex++];
+		if (object)
+		{
+			if (object->GetClass() != planClass)
+			{
+				planClass = object->GetClass();
+				plan = FSQLiteBindingPlan::Get(planClass, columns);
+			}
+			plan->Apply(row.GetStatement().Get(), object);
+			populated++;
+		}
+		if (rowIndex == ObjectsToPopulate.Num())
+		{
+			break;
+		}
+	}
+
+	if (cursor.HasError())
+	{
+		LOGSQLITE(Error, *FString::Printf(TEXT("Query resulted in an error: '%s'"), *cursor.GetErrorMessage()));
+	}
+	return populated;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+TArray<UObject*> USQLiteDatabase::GetDataIntoNewObjects(const FString& DatabaseName, const FString& Query, TSubclassOf<UObject> ObjectClass, UObject* Outer)
+{
+	return GetDataIntoNewObjects(Databases.Find(DatabaseName), Query, ObjectClass.Get(), Outer);
+}
+
+TArray<UObject*> USQLiteDatabase::GetDataIntoNewObjects(FSQLiteDatabaseHandle Database, const FString& Query, UClass* ObjectClass,
+	UObject* Outer, int32 ExpectedRows)
+{
+	LOGSQLITE(Verbose, *Query);
+
+	TArray<UObject*> objects;
+	if (!ObjectClass || ObjectClass->HasAnyClassFlags(CLASS_Abstract))
+	{
+		LOGSQLITE(Error, TEXT("Get Data Into New Objects needs a class that isn't abstract!"));
+		return objects;
+	}
+
+	FSQLiteRowCursor cursor;
+	if (!cursor.Open(Database, Query))
+	{
+		return objects;
+	}
+
+	const TSharedRef<const FSQLiteBindingPlan, ESPMode::ThreadSafe> plan = FSQLiteBindingPlan::Get(ObjectClass, cursor.GetColumns());
+	if (!plan->HasBindings())
+	{
+		LOGSQLITE(Warning, *FString::Printf(TEXT("No result column matches a property of '%s'"), *ObjectClass->GetName()));
+	}
+
+	UObject* outer = Outer ? Outer : GetTransientPackage();
+	objects.Reserve(ExpectedRows);
+	for (const FSQLiteRowCursor& row : cursor)
+	{
+		UObject* object = NewObject<UObject>(outer, ObjectClass);
+		plan->Apply(row.GetStatement().Get(), object);
+		objects.Add(object);
+	}
+
+	if (cursor.HasError())
+	{
+		LOGSQLITE(Error, *FString::Printf(TEXT("Query resulted in an error: '%s'"), *cursor.GetErrorMessage()));
+	}
+	return objects;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+bool USQLiteDatabase::SaveObjectToTable(const FString& DatabaseName, const FString& TableName, UObject* Object)
+{
+	return SaveObjectsToTable(Databases.Find(DatabaseName), TableName, TArray<UObject*>{ Object });
+}
+
+bool USQLiteDatabase::SaveObjectToTable(FSQLiteDatabaseHandle Database, const FString& TableName, UObject* Object)
+{
+	return SaveObjectsToTable(Database, TableName, TArray<UObject*>{ Object });
+}
+
+bool USQLiteDatabase::SaveObjectsToTable(const FString& DatabaseName, const FString& TableName, const TArray<UObject*>& Objects)
+{
+	return SaveObjectsToTable(Databases.Find(DatabaseName), TableName, Objects);
+}
+
+bool USQLiteDatabase::SaveObjectsToTable(FSQLiteDatabaseHandle Database, const FString& TableName, const TArray<UObject*>& Objects)
+{
+	LOGSQLITE(Verbose, *FString::Printf(TEXT("Saving %d objects to %s"), Objects.Num(), *TableName));
+
+	FSQLitePooledConnection connection = AcquireConnection(Database);
+	if (!connection.IsValid())
+	{
+		return false;
+	}
+	sqlite3* db = connection.GetDb();
+
+	// The table's columns, from a statement that is only prepared (and cached), never stepped
+	FSQLiteCachedStatement statement;
+	if (PrepareStatement(connection, TEXT("SELECT * FROM ") + TableName, statement) != SQLITE_OK || !statement.IsValid())
+	{
+		LOGSQLITE(Error, *FString::Printf(TEXT("Unable to save objects to '%s': %s"), *TableName, UTF8_TO_TCHAR(sqlite3_errmsg(db))));
+		return false;
+	}
+	const FSQLiteColumnsPtr columns = statement.GetColumns();
+	statement.Release();
+
+	// A savepoint works as a transaction of its own, or nests in one this thread began with ExecSql("BEGIN"),
+	// since a connection released inside a transaction is handed back to the same thread until it ends
+	if (sqlite3_exec(db, "SAVEPOINT SaveObjectsToTable", nullptr, nullptr, nullptr) != SQLITE_OK)
+	{
+		LOGSQLITE(Error, *FString::Printf(TEXT("Unable to begin a transaction: %s"), UTF8_TO_TCHAR(sqlite3_errmsg(db))));
+		return false;
+	}
+
+	// Objects of the same class share a plan and an upsert statement, they are only looked up again when the class changes
+	TSharedPtr<const FSQLiteBindingPlan, ESPMode::ThreadSafe> plan;
+	const UClass* planClass = nullptr;
+	bool success = true;
+
+	for (const UObject* object : Objects)
+	{
+		if (!object)
+		{
+			continue;
+		}
+
+		if (object->GetClass() != planClass)
+		{
+			planClass = object->GetClass();
+			plan = FSQLiteBindingPlan::Get(planClass, columns);
+			statement.Release();
+			if (!plan->HasBindings())
+			{
+				LOGSQLITE(Error, *FString::Printf(TEXT("No property of '%s' matches a column of '%s'"), *planClass->GetName(), *TableName));
+				success = false;
+				break;
+			}
+
+			TArray<FString> names;
+			for (int32 c = 0; c < plan->Num(); c++)
+			{
+				if (plan->GetBinding(c).Kind != FSQLiteBindingPlan::EKind::None)
+				{
+					names.Add((*columns)[c].Name);
+				}
+			}
+			TArray<FString> parameters;
+			parameters.Init(TEXT("?"), names.Num());
+			const FString query = FString::Printf(TEXT("INSERT OR REPLACE INTO %s (%s) VALUES (%s)"),
+				*TableName, *FString::Join(names, TEXT(", ")), *FString::Join(parameters, TEXT(", ")));
+
+			if (PrepareStatement(connection, query, statement) != SQLITE_OK || !statement.IsValid())
+			{
+				LOGSQLITE(Error, *FString::Printf(TEXT("Unable to prepare '%s': %s"), *query, UTF8_TO_TCHAR(sqlite3_errmsg(db))));
+				success = false;
+				break;
+			}
+		}
+
+		if (plan->BindParameters(statement.Get(), object) != SQLITE_OK || sqlite3_step(statement.Get()) != SQLITE_DONE)
+		{
+			LOGSQLITE(Error, *FString::Printf(TEXT("Unable to save '%s': %s"), *object->GetName(), UTF8_TO_TCHAR(sqlite3_errmsg(db))));
+			success = false;
+			break;
+		}
+		sqlite3_reset(statement.Get());
+	}
+	statement.Release();
+
+	if (!success)
+	{
+		sqlite3_exec(db, "ROLLBACK TO SaveObjectsToTable", nullptr, nullptr, nullptr);
+	}
+	if (sqlite3_exec(db, "RELEASE SaveObjectsToTable", nullptr, nullptr, nullptr) != SQLITE_OK)
+	{
+		LOGSQLITE(Error, *FString::Printf(TEXT("Unable to commit the transaction: %s"), UTF8_TO_TCHAR(sqlite3_errmsg(db))));
+		// Don't leave the pooled connection inside an open transaction
+		sqlite3_exec(db, "ROLLBACK TO SaveObjectsToTable; RELEASE SaveObjectsToTable", nullptr, nullptr, nullptr);
+		return false;
+	}
+	return success;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+bool USQLiteDatabase::GetDataIntoStructsBP(const FString& DatabaseName, const FString& Query, const TArray<int32>& Structs)
 {
+	// Never called, the custom thunk calls GetDataIntoStructArray with the actual array
+	check(0);
+	return false;
+}
 
-	UClass* SourceObjectClass = SourceObject->GetClass();
-	TMap<FString, FProperty*> Props;
-	for (TFieldIterator<FProperty> PropIt(SourceObjectClass, EFieldIteratorFlags::SuperClassFlags::IncludeSuper);
-		PropIt; ++PropIt)
+bool USQLiteDatabase::GetDataIntoStructArray(FSQLiteDatabaseHandle Database, const FString& Query, const FArrayProperty* ArrayProperty,
+	void* ArrayAddress)
+{
+	const FStructProperty* structProperty = CastField<FStructProperty>(ArrayProperty->Inner);
+	if (!structProperty)
 	{
-		Props.Add(*PropIt->GetNameCPP(), *PropIt);
+		LOGSQLITE(Error, TEXT("Get Data Into Structs needs an array of structs!"));
+		return false;
 	}
 
-	return Props;
+	FScriptArrayHelper array(ArrayProperty, ArrayAddress);
+	array.EmptyValues();
+	return GetDataIntoStructs(Database, Query, structProperty->Struct,
+		[&array]() -> void* { return array.GetRawPtr(array.AddValue()); });
+}
+
+bool USQLiteDatabase::GetDataIntoStructs(FSQLiteDatabaseHandle Database, const FString& Query, const UScriptStruct* Struct,
+	TFunctionRef<void*()> AddElement)
+{
+	LOGSQLITE(Verbose, *Query);
+
+	FSQLiteRowCursor cursor;
+	if (!Struct || !cursor.Open(Database, Query))
+	{
+		return false;
+	}
+
+	const TSharedRef<const FSQLiteBindingPlan, ESPMode::ThreadSafe> plan = FSQLiteBindingPlan::Get(Struct, cursor.GetColumns());
+	if (!plan->HasBindings())
+	{
+		LOGSQLITE(Warning, *FString::Printf(TEXT("No result column matches a member of '%s'"), *Struct->GetName()));
+	}
+
+	for (const FSQLiteRowCursor& row : cursor)
+	{
+		plan->Apply(row.GetStatement().Get(), AddElement());
+	}
+
+	if (cursor.HasError())
+	{
+		LOGSQLITE(Error, *FString::Printf(TEXT("Query resulted in an error: '%s'"), *cursor.GetErrorMessage()));
+		return false;
+	}
+	return true;
 }
 
 //--------------------------------------------------------------------------------------------------------------
 
 bool USQLiteDatabase::IsDatabaseRegistered(const FString& DatabaseName)
 {
-	return Databases.Contains(DatabaseName);
+	return Databases.Find(DatabaseName).IsSet();
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+FSQLiteDatabaseHandle USQLiteDatabase::GetDatabaseHandle(const FString& DatabaseName)
+{
+	return Databases.Find(DatabaseName);
+}
+
+bool USQLiteDatabase::IsDatabaseHandleValid(FSQLiteDatabaseHandle Database)
+{
+	return Databases.IsValid(Database);
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+void USQLiteDatabase::PruneIdleConnections()
+{
+	for (const TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe>& pool : Databases.GetPools())
+	{
+		pool->PruneIdleConnections();
+	}
+}
+
+void USQLiteDatabase::SetMaxOpenConnections(int32 MaxOpenConnections)
+{
+	FSQLiteConnectionPool::SetMaxTotalConnections(MaxOpenConnections);
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+bool USQLiteDatabase::RevalidateDatabase(const FString& DatabaseName)
+{
+	TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe> pool = Databases.GetPool(Databases.Find(DatabaseName));
+	if (!pool.IsValid())
+	{
+		LOGSQLITE(Error, TEXT("DB not registered."));
+		return false;
+	}
+	pool->RequestRevalidation();
+	return pool->IsValidDatabase();
 }
 
 //--------------------------------------------------------------------------------------------------------------
@@ -326,49 +694,185 @@ bool USQLiteDatabase::IsValidDatabase(const FString& DatabaseFilename, bool Test
 	return false;
 }
 
-//--------------------------------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------------------------------
+
+FSQLiteQueryResult USQLiteDatabase::GetData(const FString& DatabaseName, const FString& Query)
+{
+	return GetData(Databases.Find(DatabaseName), Query);
+}
+
+FSQLiteQueryResult USQLiteDatabase::GetDataByHandle(FSQLiteDatabaseHandle Database, const FString& Query)
+{
+	return GetData(Database, Query);
+}
+
+FSQLiteQueryResult USQLiteDatabase::GetData(FSQLiteDatabaseHandle Database, const FString& Query)
+{
+	FSQLiteQueryResult result;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Validate the database
+	//////////////////////////////////////////////////////////////////////////
+
+	TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe> pool = Databases.GetPool(Database);
+	if (!pool.IsValid() || !pool->IsValidDatabase())
+	{
+		LOGSQLITE(Error, TEXT("Unable to get data to object, database validation failed!"));
+		result.Success = false;
+		result.ErrorMessage = TEXT("Database validation failed");
+		return result;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Get the results, straight from the statement into the Blueprint rows
+	//////////////////////////////////////////////////////////////////////////
+
+	LOGSQLITE(Verbose, *Query);
+
+	FSQLiteRowCursor cursor;
+	const FSQLiteColumnsPtr columns = cursor.Open(Database, Query) ? cursor.GetColumns() : FSQLiteColumnsPtr();
+	if (!columns.IsValid())
+	{
+		result.Success = false;
+		result.ErrorMessage = "SQL error: " + cursor.GetErrorMessage();
+		return result;
+	}
+	result.SetColumns(*columns);
+	for (const FSQLiteRowCursor& row : cursor)
+	{
+		ReadBlueprintRow(row.GetStatement().Get(), *columns, result.ResultRows.AddDefaulted_GetRef());
+	}
+
+	result.Success = !cursor.HasError();
+	if (!result.Success)
+	{
+		result.ErrorMessage = "SQL error: " + cursor.GetErrorMessage();
+		result.ResultRows.Empty();
+	}
+
+	return result;
+
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+bool USQLiteDatabase::GetData(const FString& DatabaseName, const FString& Query, TFunctionRef<bool(const FSQLiteRowCursor& Row)> OnRow)
+{
+	return GetData(Databases.Find(DatabaseName), Query, OnRow);
+}
+
+bool USQLiteDatabase::GetData(FSQLiteDatabaseHandle Database, const FString& Query, TFunctionRef<bool(const FSQLiteRowCursor& Row)> OnRow)
+{
+	LOGSQLITE(Verbose, *Query);
+
+	FSQLiteRowCursor cursor;
+	if (!cursor.Open(Database, Query))
+	{
+		return false;
+	}
+
+	for (const FSQLiteRowCursor& row : cursor)
+	{
+		if (!OnRow(row))
+		{
+			return true;
+		}
+	}
+	return !cursor.HasError();
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+FSQLiteTypedQueryResult USQLiteDatabase::GetTypedData(const FString& DatabaseName, const FString& Query)
+{
+	return GetTypedData(Databases.Find(DatabaseName), Query);
+}
+
+FSQLiteTypedQueryResult USQLiteDatabase::GetTypedDataByHandle(FSQLiteDatabaseHandle Database, const FString& Query)
+{
+	return GetTypedData(Database, Query);
+}
 
-FSQLiteQueryResult USQLiteDatabase::GetData(const FString& DatabaseName, const FString& Query)
+FSQLiteTypedQueryResult USQLiteDatabase::GetTypedData(FSQLiteDatabaseHandle Database, const FString& Query)
 {
-	FSQLiteQueryResult result;
+	LOGSQLITE(Verbose, *Query);
 
-	//////////////////////////////////////////////////////////////////////////
-	// Validate the database
-	//////////////////////////////////////////////////////////////////////////
+	FSQLiteTypedQueryResult result;
 
-	if (!IsDatabaseRegistered(DatabaseName) ||
-		!IsValidDatabase(Databases[DatabaseName], true))
+	FSQLiteRowCursor cursor;
+	if (!cursor.Open(Database, Query))
 	{
-		LOGSQLITE(Error, TEXT("Unable to get data to object, database validation failed!"));
-		result.Success = false;
-		result.ErrorMessage = TEXT("Database validation failed");
+		result.ErrorMessage = TEXT("Database not registered or the query could not be prepared");
 		return result;
 	}
 
-	//////////////////////////////////////////////////////////////////////////
-	// Get the results
-	//////////////////////////////////////////////////////////////////////////
-
-	TUniquePtr<SQLiteQueryResult> queryResult = RunQueryAndGetResults(DatabaseName, Query);
-	result.Success = queryResult->Success;
-	result.ErrorMessage = queryResult->ErrorMessage;
-
-	for (auto row : queryResult->Results)
+	const int32 columnCount = cursor.NumColumns();
+	if (const FSQLiteColumnsPtr columns = cursor.GetColumns())
 	{
-		FSQLiteQueryResultRow outRow;
-		for (auto field : row.Fields)
+		result.Columns.Reserve(columnCount);
+		for (const FSQLiteColumnInfo& column : *columns)
 		{
-			FSQLiteKeyValuePair outField;
-			outField.Key = field.Name;
-			outField.Value = field.ToString();
+			result.Columns.Add(column.Name);
+		}
+	}
 
-			outRow.Fields.Add(outField);
+	for (const FSQLiteRowCursor& row : cursor)
+	{
+		TArray<FSQLiteValue>& values = result.ResultRows.AddDefaulted_GetRef().Values;
+		values.Reserve(columnCount);
+		for (int32 c = 0; c < columnCount; c++)
+		{
+			values.Add(row.GetValue(c));
 		}
-		result.ResultRows.Add(outRow);
 	}
 
+	result.Success = !cursor.HasError();
+	if (!result.Success)
+	{
+		result.ErrorMessage = "SQL error: " + cursor.GetErrorMessage();
+	}
 	return result;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+int64 FSQLiteValue::AsInteger() const
+{
+	switch (Type)
+	{
+	case ESQLiteValueType::Integer: return IntegerValue;
+	case ESQLiteValueType::Float: return (int64)FloatValue;
+	case ESQLiteValueType::Text: return FCString::Atoi64(*TextValue);
+	default: return 0;
+	}
+}
+
+double FSQLiteValue::AsFloat() const
+{
+	switch (Type)
+	{
+	case ESQLiteValueType::Integer: return (double)IntegerValue;
+	case ESQLiteValueType::Float: return FloatValue;
+	case ESQLiteValueType::Text: return FCString::Atod(*TextValue);
+	default: return 0.0;
+	}
+}
 
+FString FSQLiteValue::AsString() const
+{
+	switch (Type)
+	{
+	case ESQLiteValueType::Integer: return FString::Printf(TEXT("%lld"), IntegerValue);
+	// sqlite's own REAL to TEXT conversion, same as FSQLiteColumnarResult
+	case ESQLiteValueType::Float: return FString::Printf(TEXT("%.15g"), FloatValue);
+	case ESQLiteValueType::Text: return TextValue;
+	case ESQLiteValueType::Blob:
+	{
+		const FUTF8ToTCHAR converted(reinterpret_cast<const ANSICHAR*>(BlobValue.GetData()), BlobValue.Num());
+		return FString(converted.Length(), converted.Get());
+	}
+	default: return FString();
+	}
 }
 
 //--------------------------------------------------------------------------------------------------------------
@@ -443,24 +947,87 @@ FString USQLiteDatabase::ConstructQuery(TArray<FString> Tables, TArray<FString>
 
 //--------------------------------------------------------------------------------------------------------------
 
-bool USQLiteDatabase::PrepareStatement(const FString& DatabaseName, const FString& Query, sqlite3** Db, int32** SqlReturnCode,
-	sqlite3_stmt** PreparedStatement) {
+FSQLitePooledConnection USQLiteDatabase::AcquireConnection(const FString& DatabaseName) {
+    return AcquireConnection(Databases.Find(DatabaseName));
+}
+
+FSQLitePooledConnection USQLiteDatabase::AcquireConnection(FSQLiteDatabaseHandle Database) {
 
-    const FString* databaseName = Databases.Find(DatabaseName);
-    if (!databaseName) {
+    TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe> pool = Databases.GetPool(Database);
+    if (!pool.IsValid()) {
         LOGSQLITE(Error, TEXT("DB not registered."));
-        return false;
+        return FSQLitePooledConnection();
     }
 
-    const bool keepOpen = SQLite3Databases.Contains(DatabaseName);
-    if (keepOpen) {
-        *Db = SQLite3Databases[DatabaseName];
-    } else {
-        sqlite3_open(TCHAR_TO_ANSI(**databaseName), Db);
+    FSQLitePooledConnection connection = pool->Acquire();
+    if (!connection.IsValid()) {
+        LOGSQLITE(Error, TEXT("DB open failed."));
+    }
+    return connection;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+int32 USQLiteDatabase::PrepareQuery(const FString& DatabaseName, const FString& Query, FSQLitePooledConnection& OutConnection,
+	FSQLiteCachedStatement& OutStatement) {
+    return PrepareQuery(Databases.Find(DatabaseName), Query, OutConnection, OutStatement);
+}
+
+int32 USQLiteDatabase::PrepareQuery(FSQLiteDatabaseHandle Database, const FString& Query, FSQLitePooledConnection& OutConnection,
+	FSQLiteCachedStatement& OutStatement) {
+
+    OutStatement.Release();
+    OutConnection.Release();
+
+    TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe> pool = Databases.GetPool(Database);
+    if (!pool.IsValid()) {
+        LOGSQLITE(Error, TEXT("DB not registered."));
+        return SQLITE_CANTOPEN;
+    }
+
+    OutConnection = pool->AcquireReader();
+    if (!OutConnection.IsValid()) {
+        LOGSQLITE(Error, TEXT("DB open failed."));
+        return SQLITE_CANTOPEN;
+    }
+
+    int32 sqlReturnCode = PrepareStatement(OutConnection, Query, OutStatement);
+    if (sqlReturnCode == SQLITE_OK && OutStatement.IsValid() && OutConnection.IsThreadReader()
+        && !sqlite3_stmt_readonly(OutStatement.Get())) {
+        /* Writes go through the single writer connection of a WAL database */
+        OutStatement.Release();
+        OutConnection = pool->Acquire();
+        if (!OutConnection.IsValid()) {
+            LOGSQLITE(Error, TEXT("DB open failed."));
+            return SQLITE_CANTOPEN;
+        }
+        sqlReturnCode = PrepareStatement(OutConnection, Query, OutStatement);
     }
+    return sqlReturnCode;
+}
+
+//--------------------------------------------------------------------------------------------------------------
 
-	**SqlReturnCode = sqlite3_prepare_v2(*Db, TCHAR_TO_UTF8(*Query), -1, PreparedStatement, NULL);
-    return keepOpen;
+int32 USQLiteDatabase::PrepareStatement(const FSQLitePooledConnection& Connection, const FString& Query, FSQLiteCachedStatement& PreparedStatement) {
+
+	return Connection.GetConnection()->GetStatementCache().Acquire(Query, PreparedStatement);
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+FSQLiteStatementCacheStats USQLiteDatabase::GetStatementCacheStats(const FString& DatabaseName)
+{
+	return GetStatementCacheStats(Databases.Find(DatabaseName));
+}
+
+FSQLiteStatementCacheStats USQLiteDatabase::GetStatementCacheStats(FSQLiteDatabaseHandle Database)
+{
+	TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe> pool = Databases.GetPool(Database);
+	if (!pool.IsValid()) {
+		LOGSQLITE(Error, TEXT("DB not registered."));
+		return FSQLiteStatementCacheStats();
+	}
+	return pool->GetStatementCacheStats();
 }
 
 //--------------------------------------------------------------------------------------------------------------
@@ -468,8 +1035,16 @@ bool USQLiteDatabase::PrepareStatement(const FString& DatabaseName, const FStrin
 FSQLiteTable USQLiteDatabase::CreateTable(const FString& DatabaseName, const FString& TableName,
 	const TArray<FSQLiteTableField> Fields, const FSQLitePrimaryKey PK)
 {
-	FSQLiteTable t;
+	FSQLiteTable t = CreateTable(Databases.Find(DatabaseName), TableName, Fields, PK);
 	t.DatabaseName = DatabaseName;
+	return t;
+}
+
+FSQLiteTable USQLiteDatabase::CreateTable(FSQLiteDatabaseHandle Database, const FString& TableName,
+	const TArray<FSQLiteTableField> Fields, const FSQLitePrimaryKey PK)
+{
+	FSQLiteTable t;
+	t.DatabaseName = Databases.GetName(Database);
 	t.TableName = TableName;
 	t.Fields = Fields;
 	t.PK = PK;
@@ -513,7 +1088,7 @@ FSQLiteTable USQLiteDatabase::CreateTable(const FString& DatabaseName, const FSt
 
 	//LOGSQLITE(Warning, *query);
 
-	t.Created = ExecSql(DatabaseName, query);
+	t.Created = ExecSql(Database, query);
 
 	return t;
 
@@ -523,21 +1098,36 @@ FSQLiteTable USQLiteDatabase::CreateTable(const FString& DatabaseName, const FSt
 
 bool USQLiteDatabase::DropTable(const FString& DatabaseName, const FString& TableName)
 {
-	return ExecSql(DatabaseName, "DROP TABLE " + TableName);
+	return DropTable(Databases.Find(DatabaseName), TableName);
+}
+
+bool USQLiteDatabase::DropTable(FSQLiteDatabaseHandle Database, const FString& TableName)
+{
+	return ExecSql(Database, "DROP TABLE " + TableName);
 }
 
 //--------------------------------------------------------------------------------------------------------------
 
 bool USQLiteDatabase::TruncateTable(const FString& DatabaseName, const FString& TableName)
 {
-	return ExecSql(DatabaseName, "DELETE FROM " + TableName + ";");
+	return TruncateTable(Databases.Find(DatabaseName), TableName);
+}
+
+bool USQLiteDatabase::TruncateTable(FSQLiteDatabaseHandle Database, const FString& TableName)
+{
+	return ExecSql(Database, "DELETE FROM " + TableName + ";");
 }
 
 //--------------------------------------------------------------------------------------------------------------
 
 bool USQLiteDatabase::Vacuum(const FString& DatabaseName)
 {
-	return ExecSql(DatabaseName, "VACUUM; ");
+	return Vacuum(Databases.Find(DatabaseName));
+}
+
+bool USQLiteDatabase::Vacuum(FSQLiteDatabaseHandle Database)
+{
+	return ExecSql(Database, "VACUUM; ");
 }
 
 //--------------------------------------------------------------------------------------------------------------
@@ -573,43 +1163,63 @@ int32 USQLiteDatabase::LastInsertRowid(const FString& DatabaseName) {
 
 //--------------------------------------------------------------------------------------------------------------
 bool USQLiteDatabase::ExecSql(const FString& DatabaseName, const FString& Query) {
+	return ExecSql(Databases.Find(DatabaseName), Query);
+}
+
+bool USQLiteDatabase::ExecSqlByHandle(FSQLiteDatabaseHandle Database, const FString& Query) {
+	return ExecSql(Database, Query);
+}
+
+bool USQLiteDatabase::ExecSql(FSQLiteDatabaseHandle Database, const FString& Query) {
 	LOGSQLITE(Verbose, *Query);
 
-	sqlite3 *db = nullptr;
-    const FString* databaseName = Databases.Find(DatabaseName);
-    if (!databaseName) {
-        LOGSQLITE(Error, TEXT("DB not registered."));
+    FSQLitePooledConnection connection = AcquireConnection(Database);
+    if (!connection.IsValid()) {
         return false;
     }
+    sqlite3* db = connection.GetDb();
 
-    const bool keepOpen = SQLite3Databases.Contains(DatabaseName);
-    if (keepOpen) {
-        db = SQLite3Databases[DatabaseName];
-    }
-    else {
-        if (sqlite3_open(TCHAR_TO_ANSI(**databaseName), &db) != SQLITE_OK) {
-            LOGSQLITE(Error, TEXT("DB open failed."));
-            return false;
-        }
+    FSQLiteCachedStatement statement;
+    int32 sqlReturnCode = PrepareStatement(connection, Query, statement);
+    if (sqlReturnCode != SQLITE_OK) {
+        UE_LOG(LogDatabase, Error, TEXT("SQLite: Query Exec Failed: %s"), UTF8_TO_TCHAR(sqlite3_errmsg(db)));
+        return false;
     }
 
     bool success = false;
-    char *zErrMsg = nullptr;
-    if (sqlite3_exec(db, TCHAR_TO_UTF8(*Query), NULL, 0, &zErrMsg) == SQLITE_OK) {
+    if (!statement.IsValid()) {
+        /* Nothing but whitespace or comments */
         success = true;
+    } else if (!statement.HasTail()) {
+        /* A single statement, step the cached one */
+        while ((sqlReturnCode = sqlite3_step(statement.Get())) == SQLITE_ROW) {}
+        success = sqlReturnCode == SQLITE_DONE;
+        if (!success) {
+            UE_LOG(LogDatabase, Error, TEXT("SQLite: Query Exec Failed: %s"), UTF8_TO_TCHAR(sqlite3_errmsg(db)));
+        }
     } else {
-        UE_LOG(LogDatabase, Error, TEXT("SQLite: Query Exec Failed: %s"), UTF8_TO_TCHAR(zErrMsg));
-        sqlite3_free(zErrMsg);
+        /* Several statements in one string, let sqlite3_exec walk through them */
+        statement.Release();
+        char *zErrMsg = nullptr;
+        if (sqlite3_exec(db, TCHAR_TO_UTF8(*Query), NULL, 0, &zErrMsg) == SQLITE_OK) {
+            success = true;
+        } else {
+            UE_LOG(LogDatabase, Error, TEXT("SQLite: Query Exec Failed: %s"), UTF8_TO_TCHAR(zErrMsg));
+            sqlite3_free(zErrMsg);
+        }
     }
 
-    if (!keepOpen) sqlite3_close(db);
-
     return success;
 }
 
 //--------------------------------------------------------------------------------------------------------------
 
 bool USQLiteDatabase::CreateIndexes(const FString& DatabaseName, const FString& TableName, const TArray<FSQLiteIndex> Indexes)
+{
+	return CreateIndexes(Databases.Find(DatabaseName), TableName, Indexes);
+}
+
+bool USQLiteDatabase::CreateIndexes(FSQLiteDatabaseHandle Database, const FString& TableName, const TArray<FSQLiteIndex> Indexes)
 {
 	bool idxCrSts = true;
 
@@ -620,7 +1230,7 @@ bool USQLiteDatabase::CreateIndexes(const FString& DatabaseName, const FString&
 
 			//LOGSQLITE(Warning, *query);
 
-			idxCrSts = ExecSql(DatabaseName, query);
+			idxCrSts = ExecSql(Database, query);
 			if (!idxCrSts) {
 				//LOGSQLITE(Warning, TEXT("ExecSql break"));
 				break;
@@ -637,39 +1247,60 @@ bool USQLiteDatabase::CreateIndexes(const FString& DatabaseName, const FString&
 
 bool USQLiteDatabase::CreateIndex(const FString& DatabaseName, const FString& TableName, const FSQLiteIndex Index)
 {
-	return ExecSql(DatabaseName, Index.ResultStr.Replace(TEXT("$$$TABLE_NAME$$$"), *TableName));
+	return CreateIndex(Databases.Find(DatabaseName), TableName, Index);
+}
+
+bool USQLiteDatabase::CreateIndex(FSQLiteDatabaseHandle Database, const FString& TableName, const FSQLiteIndex Index)
+{
+	return ExecSql(Database, Index.ResultStr.Replace(TEXT("$$$TABLE_NAME$$$"), *TableName));
 }
 
 //--------------------------------------------------------------------------------------------------------------
 
 bool USQLiteDatabase::DropIndex(const FString& DatabaseName, const FString& IndexName)
 {
-	return ExecSql(DatabaseName, "DROP INDEX " + IndexName);
+	return DropIndex(Databases.Find(DatabaseName), IndexName);
+}
+
+bool USQLiteDatabase::DropIndex(FSQLiteDatabaseHandle Database, const FString& IndexName)
+{
+	return ExecSql(Database, "DROP INDEX " + IndexName);
 }
 
 //--------------------------------------------------------------------------------------------------------------
 
 bool USQLiteDatabase::IsTableExists(const FString& DatabaseName, const FString& TableName)
 {
+	return IsTableExists(Databases.Find(DatabaseName), TableName);
+}
 
-	sqlite3* db;
-	int32 sqlReturnCode = 0;
-	int32* sqlReturnCode1 = &sqlReturnCode;
-	sqlite3_stmt* preparedStatement;
+bool USQLiteDatabase::IsTableExistsByHandle(FSQLiteDatabaseHandle Database, const FString& TableName)
+{
+	return IsTableExists(Database, TableName);
+}
+
+bool USQLiteDatabase::IsTableExists(FSQLiteDatabaseHandle Database, const FString& TableName)
+{
 
 	FString Query = "SELECT * FROM sqlite_master WHERE type='table' AND name='" + TableName + "';";
 
-	const bool keepOpen = PrepareStatement(DatabaseName, Query, &db, &sqlReturnCode1, &preparedStatement);
-	sqlReturnCode = *sqlReturnCode1;
+	FSQLitePooledConnection connection;
+	FSQLiteCachedStatement statement;
+	int32 sqlReturnCode = PrepareQuery(Database, Query, connection, statement);
+	sqlite3_stmt* preparedStatement = statement.Get();
+
+	if (!connection.IsValid())
+	{
+		return false;
+	}
 
 	if (sqlReturnCode != SQLITE_OK)
 	{
-		const char* errorMessage = sqlite3_errmsg(db);
+		const char* errorMessage = sqlite3_errmsg(connection.GetDb());
 		FString error = "SQL error: " + FString(UTF8_TO_TCHAR(errorMessage));
 		LOGSQLITE(Error, *error);
 		LOGSQLITE(Error, *FString::Printf(TEXT("The attempted query was: %s"), *Query));
-		sqlite3_finalize(preparedStatement);
-        if (!keepOpen) sqlite3_close(db);
+		return false;
 	}
 
 	bool tableExists = false;
@@ -683,12 +1314,9 @@ bool USQLiteDatabase::IsTableExists(const FString& DatabaseName, const FString&
 	}
 
 	//////////////////////////////////////////////////////////////////////////
-	// Release the statement and close the connection
+	// The statement goes back to the cache, the connection back to the pool
 	//////////////////////////////////////////////////////////////////////////
 
-	sqlite3_finalize(preparedStatement);
-    if (!keepOpen) sqlite3_close(db);
-
 	return tableExists;
 
 }
@@ -696,6 +1324,10 @@ bool USQLiteDatabase::IsTableExists(const FString& DatabaseName, const FString&
 //--------------------------------------------------------------------------------------------------------------
 
 bool USQLiteDatabase::InsertRowsIntoTable(const FString& DatabaseName, const FString& TableName, TArray<FSQLiteTableRowSimulator> rowsOfFields){
+	return InsertRowsIntoTable(Databases.Find(DatabaseName), TableName, rowsOfFields);
+}
+
+bool USQLiteDatabase::InsertRowsIntoTable(FSQLiteDatabaseHandle Database, const FString& TableName, TArray<FSQLiteTableRowSimulator> rowsOfFields){
 	bool success = true;
 
 	for (FSQLiteTableRowSimulator row : rowsOfFields) {
@@ -721,7 +1353,7 @@ bool USQLiteDatabase::InsertRowsIntoTable(const FString& DatabaseName, const FSt
 
 		//LOGSQLITE(Warning, *query);
 
-		success &= ExecSql(DatabaseName, query);
+		success &= ExecSql(Database, query);
 
 	}
 
@@ -731,6 +1363,11 @@ bool USQLiteDatabase::InsertRowsIntoTable(const FString& DatabaseName, const FSt
 //--------------------------------------------------------------------------------------------------------------
 
 bool USQLiteDatabase::UpdateRowsInTable(const FString& DatabaseName, const FString& TableName, TArray<FSQLiteTableRowSimulator> rowsOfFields,
+	FSQLiteQueryFinalizedQuery Query, int32 MaxResults, int32 ResultOffset) {
+	return UpdateRowsInTable(Databases.Find(DatabaseName), TableName, rowsOfFields, Query, MaxResults, ResultOffset);
+}
+
+bool USQLiteDatabase::UpdateRowsInTable(FSQLiteDatabaseHandle Database, const FString& TableName, TArray<FSQLiteTableRowSimulator> rowsOfFields,
 	FSQLiteQueryFinalizedQuery Query, int32 MaxResults, int32 ResultOffset) {
 	if (Query.Query.Len() == 0)
 	{
@@ -772,7 +1409,7 @@ bool USQLiteDatabase::UpdateRowsInTable(const FString& DatabaseName, const FStri
 
 		//LOGSQLITE(Warning, *query);
 
-		success &= ExecSql(DatabaseName, query);
+		success &= ExecSql(Database, query);
 
 	}
 
@@ -781,6 +1418,11 @@ bool USQLiteDatabase::UpdateRowsInTable(const FString& DatabaseName, const FStri
 //--------------------------------------------------------------------------------------------------------------
 
 void USQLiteDatabase::DeleteRowsInTable(const FString& DatabaseName, const FString& TableName,
+	FSQLiteQueryFinalizedQuery Query) {
+	DeleteRowsInTable(Databases.Find(DatabaseName), TableName, Query);
+}
+
+void USQLiteDatabase::DeleteRowsInTable(FSQLiteDatabaseHandle Database, const FString& TableName,
 	FSQLiteQueryFinalizedQuery Query) {
 	if (Query.Query.Len() == 0)
 	{
@@ -796,30 +1438,46 @@ void USQLiteDatabase::DeleteRowsInTable(const FString& DatabaseName, const FStri
 
 	//LOGSQLITE(Warning, *query);
 
-	ExecSql(DatabaseName, query);
+	ExecSql(Database, query);
 
 }
 
 //--------------------------------------------------------------------------------------------------------------
 
 TUniquePtr<SQLiteQueryResult> USQLiteDatabase::RunQueryAndGetResults(const FString& DatabaseName, const FString& Query)
+{
+	return RunQueryAndGetResults(Databases.Find(DatabaseName), Query);
+}
+
+TUniquePtr<SQLiteQueryResult> USQLiteDatabase::RunQueryAndGetResults(FSQLiteDatabaseHandle Database, const FString& Query)
+{
+	TUniquePtr<SQLiteQueryResult> result = MakeUnique<SQLiteQueryResult>();
+	RunQueryAndGetResults(Database, Query, *result);
+	return result;
+}
+
+bool USQLiteDatabase::RunQueryAndGetResults(const FString& DatabaseName, const FString& Query, SQLiteQueryResult& OutResult)
+{
+	return RunQueryAndGetResults(Databases.Find(DatabaseName), Query, OutResult);
+}
+
+bool USQLiteDatabase::RunQueryAndGetResults(FSQLiteDatabaseHandle Database, const FString& Query, SQLiteQueryResult& OutResult)
 {
 	LOGSQLITE(Verbose, *Query);
-    const FString* databaseName = Databases.Find(DatabaseName);
-    if (!databaseName) {
-        LOGSQLITE(Error, TEXT("DB not registered."));
-        return nullptr;
-    }
 
-	SQLiteQueryResult result;
+	OutResult.Reset();
 
-	sqlite3* db;
-	int32 sqlReturnCode = 0;
-	int32* sqlReturnCode1 = &sqlReturnCode;
-	sqlite3_stmt* preparedStatement;
+	FSQLitePooledConnection connection;
+	FSQLiteCachedStatement statement;
+	int32 sqlReturnCode = PrepareQuery(Database, Query, connection, statement);
+	sqlite3_stmt* preparedStatement = statement.Get();
 
-	const bool keepOpen = PrepareStatement(DatabaseName, Query, &db, &sqlReturnCode1, &preparedStatement);
-	sqlReturnCode = *sqlReturnCode1;
+	if (!connection.IsValid())
+	{
+		OutResult.ErrorMessage = TEXT("Database not registered or could not be opened");
+		return false;
+	}
+	sqlite3* db = connection.GetDb();
 
 	if (sqlReturnCode != SQLITE_OK)
 	{
@@ -827,150 +1485,201 @@ TUniquePtr<SQLiteQueryResult> USQLiteDatabase::RunQueryAndGetResults(const FStri
 		FString error = "SQL error: " + FString(UTF8_TO_TCHAR(errorMessage));
 		LOGSQLITE(Error, *error);
 		LOGSQLITE(Error, *FString::Printf(TEXT("The attempted query was: %s"), *Query));
-		result.ErrorMessage = error;
-		result.Success = false;
-		sqlite3_finalize(preparedStatement);
-        if (!keepOpen) sqlite3_close(db);
-		return MakeUnique<SQLiteQueryResult>(MoveTemp(result));
+		OutResult.ErrorMessage = error;
+		return false;
 	}
 
 	//////////////////////////////////////////////////////////////////////////
 	// Get and assign the data
 	//////////////////////////////////////////////////////////////////////////
 
-	TArray<SQLiteResultValue> resultRows;
-
 	for (sqlReturnCode = sqlite3_step(preparedStatement);
 		sqlReturnCode != SQLITE_DONE && sqlReturnCode == SQLITE_ROW;
 		sqlReturnCode = sqlite3_step(preparedStatement))
 	{
-		SQLiteResultValue row;
-
 		LOGSQLITE(Verbose, TEXT("Query returned a result row."));
-		int32 resultColumnCount = sqlite3_column_count(preparedStatement);
-		for (int32 c = 0; c < resultColumnCount; c++)
-		{
-			int32 columnType = sqlite3_column_type(preparedStatement, c);
-			const char* columnName = sqlite3_column_name(preparedStatement, c);
-			FString columnNameStr = UTF8_TO_TCHAR(columnName);
-			SQLiteResultField val;
-			val.Name = columnNameStr;
-			switch (columnType)
-			{
-			case SQLITE_INTEGER:
-				val.Type = SQLiteResultValueTypes::Integer;
-				val.IntValue = sqlite3_column_int64(preparedStatement, c);
-				break;
-			case SQLITE_TEXT:
-				val.Type = SQLiteResultValueTypes::Text;
-				val.StringValue = UTF8_TO_TCHAR(sqlite3_column_text(preparedStatement, c));
-				break;
-			case SQLITE_FLOAT:
-				val.Type = SQLiteResultValueTypes::Float;
-				val.DoubleValue = sqlite3_column_double(preparedStatement, c);
-				break;
-			case SQLITE_NULL:
-			default:
-				val.Type = SQLiteResultValueTypes::UnsupportedValueType;
-			}
-
-			if (val.Type != SQLiteResultValueTypes::UnsupportedValueType)
-			{
-				row.Fields.Add(val);
-			}
-		}
+		ReadResultRow(preparedStatement, OutResult.Arena, OutResult.Results.AddDefaulted_GetRef());
+	}
 
-		resultRows.Add(row);
+	if (sqlReturnCode != SQLITE_DONE)
+	{
+		FString error = "SQL error: " + FString(UTF8_TO_TCHAR(sqlite3_errmsg(db)));
+		LOGSQLITE(Error, *error);
+		LOGSQLITE(Error, *FString::Printf(TEXT("The attempted query was: %s"), *Query));
+		OutResult.ErrorMessage = error;
+		OutResult.Results.Reset();
+		return false;
 	}
 
 	//////////////////////////////////////////////////////////////////////////
-	// Release the statement and close the connection
+	// The statement goes back to the cache, the connection back to the pool
 	//////////////////////////////////////////////////////////////////////////
 
-	sqlite3_finalize(preparedStatement);
-	if (!keepOpen) sqlite3_close(db);
+	OutResult.InsertedId = sqlite3_last_insert_rowid(db);
+	OutResult.Columns = statement.GetColumns();
+	OutResult.Success = true;
+	return true;
+}
 
-	result.InsertedId = sqlite3_last_insert_rowid(db);
-	result.Results = resultRows;
-	result.Success = true;
-    return MakeUnique<SQLiteQueryResult>(MoveTemp(result));
+//--------------------------------------------------------------------------------------------------------------
+
+FSQLiteColumnarResult USQLiteDatabase::RunQueryColumnar(const FString& DatabaseName, const FString& Query)
+{
+	return RunQueryColumnar(Databases.Find(DatabaseName), Query);
+}
+
+FSQLiteColumnarResult USQLiteDatabase::RunQueryColumnar(FSQLiteDatabaseHandle Database, const FString& Query)
+{
+	LOGSQLITE(Verbose, *Query);
+
+	FSQLiteColumnarResult result;
+
+	FSQLitePooledConnection connection;
+	FSQLiteCachedStatement statement;
+	int32 sqlReturnCode = PrepareQuery(Database, Query, connection, statement);
+	sqlite3_stmt* preparedStatement = statement.Get();
+
+	if (!connection.IsValid())
+	{
+		result.ErrorMessage = TEXT("Database not registered or could not be opened");
+		return result;
+	}
+	sqlite3* db = connection.GetDb();
+
+	if (sqlReturnCode != SQLITE_OK || !preparedStatement)
+	{
+		FString error = "SQL error: " + FString(UTF8_TO_TCHAR(sqlite3_errmsg(db)));
+		LOGSQLITE(Error, *error);
+		LOGSQLITE(Error, *FString::Printf(TEXT("The attempted query was: %s"), *Query));
+		result.ErrorMessage = error;
+		return result;
+	}
+
+	result.Reset(preparedStatement);
+	for (sqlReturnCode = sqlite3_step(preparedStatement);
+		sqlReturnCode == SQLITE_ROW;
+		sqlReturnCode = sqlite3_step(preparedStatement))
+	{
+		result.AddRow(preparedStatement);
+	}
 
+	if (sqlReturnCode != SQLITE_DONE)
+	{
+		FString error = "SQL error: " + FString(UTF8_TO_TCHAR(sqlite3_errmsg(db)));
+		LOGSQLITE(Error, *error);
+		LOGSQLITE(Error, *FString::Printf(TEXT("The attempted query was: %s"), *Query));
+		result.ErrorMessage = error;
+		return result;
+	}
+
+	result.Success = true;
+	return result;
 }
 
 //--------------------------------------------------------------------------------------------------------------
 
-void USQLiteDatabase::AssignResultsToObjectProperties(const SQLiteResultValue& ResultValue, UObject* ObjectToPopulate)
+void USQLiteDatabase::ReadResultRow(sqlite3_stmt* Statement, FSQLiteResultArena& Arena, SQLiteResultValue& OutRow)
 {
-	auto propertyMap = CollectProperties(ObjectToPopulate);
-	for (SQLiteResultField field : ResultValue.Fields)
+	int32 resultColumnCount = sqlite3_column_count(Statement);
+	SQLiteResultField* fields = Arena.AllocateArray<SQLiteResultField>(resultColumnCount);
+	int32 fieldCount = 0;
+
+	for (int32 c = 0; c < resultColumnCount; c++)
 	{
-		if (propertyMap.Contains(field.Name))
+		int32 columnType = sqlite3_column_type(Statement, c);
+		SQLiteResultField& val = fields[fieldCount];
+		val = SQLiteResultField();
+		val.Column = c;
+		switch (columnType)
+		{
+		case SQLITE_INTEGER:
+			val.Type = SQLiteResultValueTypes::Integer;
+			val.IntValue = sqlite3_column_int64(Statement, c);
+			break;
+		case SQLITE_TEXT:
+		{
+			// Kept as UTF-8, it's only converted if someone reads it as an FString
+			val.Type = SQLiteResultValueTypes::Text;
+			const uint8* text = sqlite3_column_text(Statement, c);
+			val.Size = sqlite3_column_bytes(Statement, c);
+			val.Data = Arena.Copy(text, val.Size);
+			break;
+		}
+		case SQLITE_FLOAT:
+			val.Type = SQLiteResultValueTypes::Float;
+			val.DoubleValue = sqlite3_column_double(Statement, c);
+			break;
+		case SQLITE_BLOB:
 		{
-			FProperty* targetProperty = propertyMap[field.Name];
+			val.Type = SQLiteResultValueTypes::Blob;
+			const uint8* data = static_cast<const uint8*>(sqlite3_column_blob(Statement, c));
+			val.Size = sqlite3_column_bytes(Statement, c);
+			val.Data = Arena.Copy(data, val.Size);
+			break;
+		}
+		case SQLITE_NULL:
+			val.Type = SQLiteResultValueTypes::Null;
+			break;
+		default:
+			val.Type = SQLiteResultValueTypes::UnsupportedValueType;
+		}
 
-			if (field.Type == SQLiteResultValueTypes::Integer)
-			{
-				FInt64Property* int64prop = NULL;
-				FIntProperty* int32prop = NULL;
-				FInt16Property* int16prop = NULL;
-				FInt8Property* int8prop = NULL;
-				FBoolProperty* boolProp = NULL;
+		// NULLs are kept too, so a field's position always matches its column
+		if (val.Type != SQLiteResultValueTypes::UnsupportedValueType)
+		{
+			fieldCount++;
+		}
+	}
 
-				if ((int64prop = CastField<FInt64Property>(targetProperty)) != NULL)
-				{
-					int64prop->SetPropertyValue_InContainer(ObjectToPopulate, field.IntValue);
-					LOGSQLITE(Verbose, *FString::Printf(TEXT("Property '%s' was set to '%d'"), *field.Name, field.IntValue));
-				}
-				else if ((int32prop = CastField<FIntProperty>(targetProperty)) != NULL)
-				{
-					int32prop->SetPropertyValue_InContainer(ObjectToPopulate, (int32)field.IntValue);
-					LOGSQLITE(Verbose, *FString::Printf(TEXT("Property '%s' was set to '%d'"), *field.Name, field.IntValue));
-				}
-				else if ((int16prop = CastField<FInt16Property>(targetProperty)) != NULL)
-				{
-					int16prop->SetPropertyValue_InContainer(ObjectToPopulate, (int16)field.IntValue);
-					LOGSQLITE(Verbose, *FString::Printf(TEXT("Property '%s' was set to '%d'"), *field.Name, field.IntValue));
-				}
-				else if ((int8prop = CastField<FInt8Property>(targetProperty)) != NULL)
-				{
-					int8prop->SetPropertyValue_InContainer(ObjectToPopulate, (int8)field.IntValue);
-					LOGSQLITE(Verbose, *FString::Printf(TEXT("Property '%s' was set to '%d'"), *field.Name, field.IntValue));
-				}
-				else if ((boolProp = CastField<FBoolProperty>(targetProperty)) != NULL)
-				{
-					boolProp->SetPropertyValue_InContainer(ObjectToPopulate, field.IntValue > 0);
-					LOGSQLITE(Verbose, *FString::Printf(TEXT("Property '%s' was set to '%d'"), *field.Name, field.IntValue));
-				}
-			}
+	OutRow.Fields = TArrayView<SQLiteResultField>(fields, fieldCount);
+}
 
-			else if (field.Type == SQLiteResultValueTypes::Float)
-			{
-				FDoubleProperty* doubleProp = NULL;
-				FFloatProperty* floatProp = NULL;
-				if ((doubleProp = CastField<FDoubleProperty>(targetProperty)) != NULL)
-				{
-					doubleProp->SetPropertyValue_InContainer(ObjectToPopulate, field.DoubleValue);
-					LOGSQLITE(Verbose, *FString::Printf(TEXT("Property '%s' was set to '%f'"), *field.Name, field.DoubleValue));
-				}
-				else if ((floatProp = CastField<FFloatProperty>(targetProperty)) != NULL)
-				{
-					floatProp->SetPropertyValue_InContainer(ObjectToPopulate, (float)field.DoubleValue);
-					LOGSQLITE(Verbose, *FString::Printf(TEXT("Property '%s' was set to '%f'"), *field.Name, field.DoubleValue));
-				}
-			}
+//--------------------------------------------------------------------------------------------------------------
 
-			else if (field.Type == SQLiteResultValueTypes::Text)
-			{
-				FStrProperty* strProp = NULL;
-				if ((strProp = CastField<FStrProperty>(targetProperty)) != NULL)
-				{
-					strProp->SetPropertyValue_InContainer(ObjectToPopulate, field.StringValue);
-					LOGSQLITE(Verbose, *FString::Printf(TEXT("Property '%s' was set to '%s'"), *field.Name, *field.StringValue.Mid(0, 64)));
-				}
-			}
+void USQLiteDatabase::ReadBlueprintRow(sqlite3_stmt* Statement, const FSQLiteColumns& Columns, FSQLiteQueryResultRow& OutRow)
+{
+	const int32 columnCount = FMath::Min(sqlite3_column_count(Statement), Columns.Num());
+	OutRow.Fields.Reset(columnCount);
+
+	for (int32 c = 0; c < columnCount; c++)
+	{
+		FSQLiteKeyValuePair& outField = OutRow.Fields.AddDefaulted_GetRef();
+		outField.Key = Columns[c].Name;
 
+		switch (sqlite3_column_type(Statement, c))
+		{
+		case SQLITE_INTEGER:
+			outField.Value = FString::Printf(TEXT("%lld"), sqlite3_column_int64(Statement, c));
+			break;
+		case SQLITE_FLOAT:
+			outField.Value = FString::Printf(TEXT("%.15g"), sqlite3_column_double(Statement, c));
+			break;
+		case SQLITE_TEXT:
+		case SQLITE_BLOB:
+		{
+			// A BLOB reads as UTF-8 too, same as in ToString
+			const ANSICHAR* text = reinterpret_cast<const ANSICHAR*>(sqlite3_column_text(Statement, c));
+			const FUTF8ToTCHAR converted(text, sqlite3_column_bytes(Statement, c));
+			outField.Value = FString(converted.Length(), converted.Get());
+			break;
+		}
+		default:
+			break;
 		}
 	}
 }
 
 //--------------------------------------------------------------------------------------------------------------
+
+void USQLiteDatabase::AssignResultsToObjectProperties(const SQLiteResultValue& ResultValue, const FSQLiteColumnsPtr& Columns, UObject* ObjectToPopulate)
+{
+	const TSharedRef<const FSQLiteBindingPlan, ESPMode::ThreadSafe> plan = FSQLiteBindingPlan::Get(ObjectToPopulate->GetClass(), Columns);
+	if (!plan->HasBindings())
+	{
+		LOGSQLITE(Warning, *FString::Printf(TEXT("No result column matches a property of '%s'"), *ObjectToPopulate->GetClass()->GetName()));
+		return;
+	}
+	plan->Apply(ResultValue, ObjectToPopulate);
+}
+
+//--------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,228 @@
+#include "SQLiteDatabaseRegistry.h"
+#include "CISQLite3PrivatePCH.h"
+
+//--------------------------------------------------------------------------------------------------------------
+
+FSQLiteDatabaseRegistry::FSQLiteDatabaseRegistry()
+{
+	for (std::atomic<FSlot*>& chunk : Chunks)
+	{
+		chunk.store(nullptr, std::memory_order_relaxed);
+	}
+}
+
+FSQLiteDatabaseRegistry::~FSQLiteDatabaseRegistry()
+{
+	for (std::atomic<FSlot*>& chunk : Chunks)
+	{
+		delete[] chunk.load(std::memory_order_relaxed);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+FSQLiteDatabaseRegistry::FSlot* FSQLiteDatabaseRegistry::FindSlot(int32 Index) const
+{
+	if (Index < 0 || Index >= NumSlots.load(std::memory_order_acquire))
+	{
+		return nullptr;
+	}
+	FSlot* chunk = Chunks[Index / SlotsPerChunk].load(std::memory_order_acquire);
+	return chunk ? &chunk[Index % SlotsPerChunk] : nullptr;
+}
+
+FSQLiteDatabaseRegistry::FShard& FSQLiteDatabaseRegistry::GetShard(const FString& Name) const
+{
+	// Same (case insensitive) hash the shard's map uses, so names differing in case share a shard
+	return Shards[GetTypeHash(Name) % NumShards];
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+int32 FSQLiteDatabaseRegistry::AllocateSlot()
+{
+	FScopeLock lock(&SlotAllocationLock);
+
+	if (FreeSlots.Num() > 0)
+	{
+		return FreeSlots.Pop(false);
+	}
+
+	const int32 index = NumSlots.load(std::memory_order_relaxed);
+	if (index >= SlotsPerChunk * MaxChunks)
+	{
+		return INDEX_NONE;
+	}
+
+	std::atomic<FSlot*>& chunk = Chunks[index / SlotsPerChunk];
+	if (!chunk.load(std::memory_order_relaxed))
+	{
+		chunk.store(new FSlot[SlotsPerChunk], std::memory_order_release);
+	}
+	NumSlots.store(index + 1, std::memory_order_release);
+	return index;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+FSQLiteDatabaseHandle FSQLiteDatabaseRegistry::Add(const FString& Name, const TSharedRef<FSQLiteConnectionPool, ESPMode::ThreadSafe>& Pool)
+{
+	FShard& shard = GetShard(Name);
+	FRWScopeLock shardLock(shard.Lock, SLT_Write);
+
+	if (shard.Handles.Contains(Name))
+	{
+		return FSQLiteDatabaseHandle();
+	}
+
+	const int32 index = AllocateSlot();
+	if (index == INDEX_NONE)
+	{
+		return FSQLiteDatabaseHandle();
+	}
+
+	FSlot& slot = *FindSlot(index);
+	FSQLiteDatabaseHandle handle;
+	{
+		FRWScopeLock slotLock(slot.Lock, SLT_Write);
+		slot.Name = Name;
+		slot.Pool = Pool;
+		handle.Index = index;
+		handle.Generation = slot.Generation;
+	}
+	shard.Handles.Add(Name, handle);
+	return handle;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe> FSQLiteDatabaseRegistry::Remove(FSQLiteDatabaseHandle Handle)
+{
+	FSlot* slot = Handle.IsSet() ? FindSlot(Handle.Index) : nullptr;
+	if (!slot)
+	{
+		return nullptr;
+	}
+
+	// The name picks the shard, the shard has to be locked before the slot
+	FString name;
+	{
+		FRWScopeLock slotLock(slot->Lock, SLT_ReadOnly);
+		if (slot->Generation != Handle.Generation || !slot->Pool.IsValid())
+		{
+			return nullptr;
+		}
+		name = slot->Name;
+	}
+
+	TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe> pool;
+	{
+		FShard& shard = GetShard(name);
+		FRWScopeLock shardLock(shard.Lock, SLT_Write);
+		FRWScopeLock slotLock(slot->Lock, SLT_Write);
+
+		// Someone else may have removed it while no lock was held
+		if (slot->Generation != Handle.Generation || !slot->Pool.IsValid())
+		{
+			return nullptr;
+		}
+
+		shard.Handles.Remove(slot->Name);
+		pool = MoveTemp(slot->Pool);
+		slot->Pool.Reset();
+		slot->Name.Empty();
+		// Skip 0 on wrap-around, it marks unset handles
+		slot->Generation = slot->Generation == MAX_int32 ? 1 : slot->Generation + 1;
+	}
+
+	FScopeLock lock(&SlotAllocationLock);
+	FreeSlots.Add(Handle.Index);
+	return pool;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+TArray<TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe>> FSQLiteDatabaseRegistry::RemoveAll()
+{
+	TArray<TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe>> pools;
+	const int32 numSlots = NumSlots.load(std::memory_order_acquire);
+	for (int32 i = 0; i < numSlots; i++)
+	{
+		FSQLiteDatabaseHandle handle;
+		handle.Index = i;
+		{
+			const FSlot* slot = FindSlot(i);
+			FRWScopeLock slotLock(slot->Lock, SLT_ReadOnly);
+			handle.Generation = slot->Generation;
+		}
+		TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe> pool = Remove(handle);
+		if (pool.IsValid())
+		{
+			pools.Add(pool);
+		}
+	}
+	return pools;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+TArray<TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe>> FSQLiteDatabaseRegistry::GetPools() const
+{
+	TArray<TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe>> pools;
+	const int32 numSlots = NumSlots.load(std::memory_order_acquire);
+	for (int32 i = 0; i < numSlots; i++)
+	{
+		const FSlot* slot = FindSlot(i);
+		FRWScopeLock slotLock(slot->Lock, SLT_ReadOnly);
+		if (slot->Pool.IsValid())
+		{
+			pools.Add(slot->Pool);
+		}
+	}
+	return pools;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+FSQLiteDatabaseHandle FSQLiteDatabaseRegistry::Find(const FString& Name) const
+{
+	const FShard& shard = GetShard(Name);
+	FRWScopeLock shardLock(shard.Lock, SLT_ReadOnly);
+	const FSQLiteDatabaseHandle* handle = shard.Handles.Find(Name);
+	return handle ? *handle : FSQLiteDatabaseHandle();
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+bool FSQLiteDatabaseRegistry::IsValid(FSQLiteDatabaseHandle Handle) const
+{
+	const FSlot* slot = Handle.IsSet() ? FindSlot(Handle.Index) : nullptr;
+	if (!slot)
+	{
+		return false;
+	}
+	FRWScopeLock slotLock(slot->Lock, SLT_ReadOnly);
+	return slot->Generation == Handle.Generation && slot->Pool.IsValid();
+}
+
+TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe> FSQLiteDatabaseRegistry::GetPool(FSQLiteDatabaseHandle Handle) const
+{
+	const FSlot* slot = Handle.IsSet() ? FindSlot(Handle.Index) : nullptr;
+	if (!slot)
+	{
+		return nullptr;
+	}
+	FRWScopeLock slotLock(slot->Lock, SLT_ReadOnly);
+	return slot->Generation == Handle.Generation ? slot->Pool : nullptr;
+}
+
+FString FSQLiteDatabaseRegistry::GetName(FSQLiteDatabaseHandle Handle) const
+{
+	const FSlot* slot = Handle.IsSet() ? FindSlot(Handle.Index) : nullptr;
+	if (!slot)
+	{
+		return FString();
+	}
+	FRWScopeLock slotLock(slot->Lock, SLT_ReadOnly);
+	return slot->Generation == Handle.Generation && slot->Pool.IsValid() ? slot->Name : FString();
+}
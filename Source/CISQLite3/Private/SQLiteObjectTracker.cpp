@@ -0,0 +1,330 @@
+#include "SQLiteObjectTracker.h"
+#include "CISQLite3PrivatePCH.h"
+
+#define LOGSQLITE(verbosity, text) UE_LOG(LogDatabase, verbosity, TEXT("SQLite: %s"), text)
+
+//--------------------------------------------------------------------------------------------------------------
+
+USQLiteObjectTracker* USQLiteObjectTracker::CreateObjectTracker(const FString& DatabaseName, const FString& TableName, const FString& KeyColumn)
+{
+	const FSQLiteDatabaseHandle database = USQLiteDatabase::GetDatabaseHandle(DatabaseName);
+	if (!USQLiteDatabase::IsDatabaseHandleValid(database))
+	{
+		LOGSQLITE(Error, *FString::Printf(TEXT("Unable to create object tracker, database '%s' is not registered"), *DatabaseName));
+		return nullptr;
+	}
+
+	// The table's columns, from a statement that is only prepared, never stepped
+	FSQLiteRowCursor cursor;
+	if (!cursor.Open(database, TEXT("SELECT * FROM ") + TableName))
+	{
+		return nullptr;
+	}
+	const FSQLiteColumnsPtr columns = cursor.GetColumns();
+
+	const int32 keyColumnIndex = columns->IndexOfByPredicate([&KeyColumn](const FSQLiteColumnInfo& Column) { return Column.Name == KeyColumn; });
+	if (keyColumnIndex == INDEX_NONE)
+	{
+		LOGSQLITE(Error, *FString::Printf(TEXT("Unable to create object tracker, '%s' has no column '%s'"), *TableName, *KeyColumn));
+		return nullptr;
+	}
+
+	USQLiteObjectTracker* tracker = NewObject<USQLiteObjectTracker>();
+	tracker->Database = database;
+	tracker->TableName = TableName;
+	tracker->KeyColumn = KeyColumn;
+	tracker->KeyColumnIndex = keyColumnIndex;
+	tracker->Columns = columns;
+	return tracker;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+TSharedPtr<const FSQLiteBindingPlan, ESPMode::ThreadSafe> USQLiteObjectTracker::GetPlan(const UObject* Object) const
+{
+	TSharedRef<const FSQLiteBindingPlan, ESPMode::ThreadSafe> plan = FSQLiteBindingPlan::Get(Object->GetClass(), Columns);
+	if (plan->GetBinding(KeyColumnIndex).Kind == FSQLiteBindingPlan::EKind::None)
+	{
+		LOGSQLITE(Error, *FString::Printf(TEXT("'%s' has no property for the key column '%s'"), *Object->GetClass()->GetName(), *KeyColumn));
+		return nullptr;
+	}
+	return plan;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+void USQLiteObjectTracker::Track(UObject* Object)
+{
+	if (!Object)
+	{
+		return;
+	}
+	const TSharedPtr<const FSQLiteBindingPlan, ESPMode::ThreadSafe> plan = GetPlan(Object);
+	if (plan.IsValid())
+	{
+		FSnapshot& snapshot = Snapshots.FindOrAdd(FObjectKey(Object));
+		plan->GetFingerprints(Object, snapshot.Fingerprints);
+		snapshot.Key = plan->GetValue(KeyColumnIndex, Object);
+	}
+}
+
+void USQLiteObjectTracker::TrackObjects(const TArray<UObject*>& Objects)
+{
+	Snapshots.Reserve(Snapshots.Num() + Objects.Num());
+	for (UObject* object : Objects)
+	{
+		Track(object);
+	}
+}
+
+void USQLiteObjectTracker::Untrack(UObject* Object)
+{
+	Snapshots.Remove(FObjectKey(Object));
+}
+
+void USQLiteObjectTracker::PruneSnapshots()
+{
+	for (auto it = Snapshots.CreateIterator(); it; ++it)
+	{
+		if (!it.Key().ResolveObjectPtr())
+		{
+			it.RemoveCurrent();
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+bool USQLiteObjectTracker::IsDirty(UObject* Object) const
+{
+	const FSnapshot* snapshot = Object ? Snapshots.Find(FObjectKey(Object)) : nullptr;
+	if (!snapshot)
+	{
+		return true;
+	}
+	const TSharedPtr<const FSQLiteBindingPlan, ESPMode::ThreadSafe> plan = GetPlan(Object);
+	TArray<uint64> fingerprints;
+	if (plan.IsValid())
+	{
+		plan->GetFingerprints(Object, fingerprints);
+	}
+	return fingerprints != snapshot->Fingerprints;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+bool USQLiteObjectTracker::SaveChanges(const TArray<UObject*>& Objects)
+{
+	LastRowsWritten = 0;
+	LastColumnsWritten = 0;
+
+	struct FPendingWrite
+	{
+		const UObject* Object;
+		TSharedPtr<const FSQLiteBindingPlan, ESPMode::ThreadSafe> Plan;
+		/** Ordinals of the columns to write */
+		TArray<int32> Columns;
+		TArray<uint64> Fingerprints;
+		FSQLiteValue Key;
+		/** For updates, the key of the row to update */
+		FSQLiteValue SavedKey;
+		FString Query;
+		bool bUpdate = false;
+	};
+
+	// Writes every bound column of an object, for new objects and rows an update didn't find
+	auto makeUpsert = [this](const FSQLiteBindingPlan& Plan, TArray<int32>& OutColumns)
+	{
+		TArray<FString> names;
+		TArray<FString> parameters;
+		for (int32 c = 0; c < Plan.Num(); c++)
+		{
+			if (Plan.GetBinding(c).Kind != FSQLiteBindingPlan::EKind::None)
+			{
+				OutColumns.Add(c);
+				names.Add((*Columns)[c].Name);
+				parameters.Add(TEXT("?"));
+			}
+		}
+		return FString::Printf(TEXT("INSERT OR REPLACE INTO %s (%s) VALUES (%s)"),
+			*TableName, *FString::Join(names, TEXT(", ")), *FString::Join(parameters, TEXT(", ")));
+	};
+
+	// Diff every object against its snapshot first, the transaction is only opened if there's something to write
+	TArray<FPendingWrite> writes;
+	for (const UObject* object : Objects)
+	{
+		if (!object)
+		{
+			continue;
+		}
+
+		FPendingWrite write;
+		write.Object = object;
+		write.Plan = GetPlan(object);
+		if (!write.Plan.IsValid())
+		{
+			return false;
+		}
+		write.Plan->GetFingerprints(object, write.Fingerprints);
+		write.Key = write.Plan->GetValue(KeyColumnIndex, object);
+
+		const FSnapshot* snapshot = Snapshots.Find(FObjectKey(object));
+		write.bUpdate = snapshot && snapshot->Fingerprints.Num() == write.Fingerprints.Num();
+
+		if (write.bUpdate)
+		{
+			TArray<FString> names;
+			int32 bound = 0;
+			for (int32 c = 0; c < write.Plan->Num(); c++)
+			{
+				if (write.Plan->GetBinding(c).Kind == FSQLiteBindingPlan::EKind::None)
+				{
+					continue;
+				}
+				// A changed key is set like any other column, the row is found by the key it was saved with
+				if (snapshot->Fingerprints[bound] != write.Fingerprints[bound])
+				{
+					write.Columns.Add(c);
+					names.Add((*Columns)[c].Name);
+				}
+				bound++;
+			}
+
+			if (write.Columns.Num() == 0)
+			{
+				continue;
+			}
+			write.Query = FString::Printf(TEXT("UPDATE %s SET %s = ? WHERE %s = ?"), *TableName, *FString::Join(names, TEXT(" = ?, ")), *KeyColumn);
+			write.SavedKey = snapshot->Key;
+		}
+		else
+		{
+			write.Query = makeUpsert(*write.Plan, write.Columns);
+		}
+		writes.Add(MoveTemp(write));
+	}
+
+	if (writes.Num() == 0)
+	{
+		return true;
+	}
+
+	// Objects that changed the same columns share one prepared statement, whatever their class
+	writes.Sort([](const FPendingWrite& A, const FPendingWrite& B) { return A.Query < B.Query; });
+
+	FSQLitePooledConnection connection = USQLiteDatabase::AcquireConnection(Database);
+	if (!connection.IsValid())
+	{
+		return false;
+	}
+	sqlite3* db = connection.GetDb();
+
+	if (sqlite3_exec(db, "SAVEPOINT SQLiteObjectTracker", nullptr, nullptr, nullptr) != SQLITE_OK)
+	{
+		LOGSQLITE(Error, *FString::Printf(TEXT("Unable to begin a transaction: %s"), UTF8_TO_TCHAR(sqlite3_errmsg(db))));
+		return false;
+	}
+
+	FSQLiteCachedStatement statement;
+	const FString* preparedQuery = nullptr;
+	bool success = true;
+
+	for (const FPendingWrite& write : writes)
+	{
+		if (!preparedQuery || *preparedQuery != write.Query)
+		{
+			statement.Release();
+			preparedQuery = &write.Query;
+			if (connection.GetConnection()->GetStatementCache().Acquire(write.Query, statement) != SQLITE_OK || !statement.IsValid())
+			{
+				LOGSQLITE(Error, *FString::Printf(TEXT("Unable to prepare '%s': %s"), *write.Query, UTF8_TO_TCHAR(sqlite3_errmsg(db))));
+				success = false;
+				break;
+			}
+		}
+
+		for (int32 p = 0; p < write.Columns.Num() && success; p++)
+		{
+			success = write.Plan->BindParameter(statement.Get(), p + 1, write.Columns[p], write.Object) == SQLITE_OK;
+		}
+		if (success && write.bUpdate)
+		{
+			success = FSQLiteStatement::BindValue(statement.Get(), write.Columns.Num() + 1, write.SavedKey) == SQLITE_OK;
+		}
+		if (!success || sqlite3_step(statement.Get()) != SQLITE_DONE)
+		{
+			LOGSQLITE(Error, *FString::Printf(TEXT("Unable to save '%s': %s"), *write.Object->GetName(), UTF8_TO_TCHAR(sqlite3_errmsg(db))));
+			success = false;
+			break;
+		}
+		sqlite3_reset(statement.Get());
+		int32 columnsWritten = write.Columns.Num();
+
+		// The row was deleted or never saved since the object was tracked, it's written whole instead
+		if (write.bUpdate && sqlite3_changes(db) == 0)
+		{
+			TArray<int32> upsertColumns;
+			const FString upsertQuery = makeUpsert(*write.Plan, upsertColumns);
+			FSQLiteCachedStatement upsert;
+			if (connection.GetConnection()->GetStatementCache().Acquire(upsertQuery, upsert) != SQLITE_OK || !upsert.IsValid())
+			{
+				LOGSQLITE(Error, *FString::Printf(TEXT("Unable to prepare '%s': %s"), *upsertQuery, UTF8_TO_TCHAR(sqlite3_errmsg(db))));
+				success = false;
+				break;
+			}
+			for (int32 p = 0; p < upsertColumns.Num() && success; p++)
+			{
+				success = write.Plan->BindParameter(upsert.Get(), p + 1, upsertColumns[p], write.Object) == SQLITE_OK;
+			}
+			if (!success || sqlite3_step(upsert.Get()) != SQLITE_DONE)
+			{
+				LOGSQLITE(Error, *FString::Printf(TEXT("Unable to save '%s': %s"), *write.Object->GetName(), UTF8_TO_TCHAR(sqlite3_errmsg(db))));
+				success = false;
+				break;
+			}
+			sqlite3_reset(upsert.Get());
+			columnsWritten = upsertColumns.Num();
+		}
+
+		LastRowsWritten++;
+		LastColumnsWritten += columnsWritten;
+	}
+	statement.Release();
+
+	if (!success)
+	{
+		sqlite3_exec(db, "ROLLBACK TO SQLiteObjectTracker", nullptr, nullptr, nullptr);
+	}
+	if (sqlite3_exec(db, "RELEASE SQLiteObjectTracker", nullptr, nullptr, nullptr) != SQLITE_OK)
+	{
+		LOGSQLITE(Error, *FString::Printf(TEXT("Unable to commit the transaction: %s"), UTF8_TO_TCHAR(sqlite3_errmsg(db))));
+		// Don't leave the pooled connection inside an open transaction
+		sqlite3_exec(db, "ROLLBACK TO SQLiteObjectTracker; RELEASE SQLiteObjectTracker", nullptr, nullptr, nullptr);
+		success = false;
+	}
+
+	if (!success)
+	{
+		LastRowsWritten = 0;
+		LastColumnsWritten = 0;
+		return false;
+	}
+
+	// Only now that the rows are committed, the written values become the saved ones
+	for (FPendingWrite& write : writes)
+	{
+		FSnapshot& snapshot = Snapshots.FindOrAdd(FObjectKey(write.Object));
+		snapshot.Fingerprints = MoveTemp(write.Fingerprints);
+		snapshot.Key = MoveTemp(write.Key);
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+void USQLiteObjectTracker::GetLastSaveStats(int32& RowsWritten, int32& ColumnsWritten) const
+{
+	RowsWritten = LastRowsWritten;
+	ColumnsWritten = LastColumnsWritten;
+}
@@ -0,0 +1,132 @@
+#include "SQLitePagedQuery.h"
+#include "CISQLite3PrivatePCH.h"
+
+#define LOGSQLITE(verbosity, text) UE_LOG(LogDatabase, verbosity, TEXT("SQLite: %s"), text)
+
+/** Alias of the key column appended to the selected fields, it's removed from the returned rows */
+static const TCHAR* const PageKeyAlias = TEXT("SQLitePageKey");
+
+//--------------------------------------------------------------------------------------------------------------
+
+USQLitePagedQuery* USQLitePagedQuery::CreatePagedQuery(const FSQLiteDatabaseReference& DataSource, TArray<FString> Fields,
+	const FSQLiteQueryFinalizedQuery& Query, const FString& KeyColumn, int32 PageSize, bool Descending)
+{
+	if (DataSource.Tables.Num() == 0)
+	{
+		LOGSQLITE(Error, TEXT("The paged query needs at least one table name!"));
+		return nullptr;
+	}
+	if (KeyColumn.IsEmpty() || PageSize <= 0)
+	{
+		LOGSQLITE(Error, TEXT("The paged query needs a key column and a page size above 0!"));
+		return nullptr;
+	}
+
+	const FSQLiteDatabaseHandle database = USQLiteDatabase::GetDatabaseHandle(DataSource.DatabaseName);
+	if (!USQLiteDatabase::IsDatabaseHandleValid(database))
+	{
+		LOGSQLITE(Error, *FString::Printf(TEXT("Unable to create paged query, database '%s' is not registered"), *DataSource.DatabaseName));
+		return nullptr;
+	}
+
+	const FString fieldString = Fields.Num() > 0 ? FString::Join(Fields, TEXT(",")) : FString(TEXT("*"));
+	const FString select = FString::Printf(TEXT("SELECT %s, %s AS %s FROM %s"),
+		*fieldString, *KeyColumn, PageKeyAlias, *FString::Join(DataSource.Tables, TEXT(",")));
+	const FString orderBy = FString::Printf(TEXT("ORDER BY %s%s LIMIT :PageSize"), *KeyColumn, Descending ? TEXT(" DESC") : TEXT(""));
+	const FString seek = FString::Printf(TEXT("%s %s :PageKey"), *KeyColumn, Descending ? TEXT("<") : TEXT(">"));
+
+	USQLitePagedQuery* pagedQuery = NewObject<USQLitePagedQuery>();
+	pagedQuery->Database = database;
+	pagedQuery->PageSize = PageSize;
+	if (Query.Query.Len() > 0)
+	{
+		pagedQuery->FirstPageQuery = FString::Printf(TEXT("%s WHERE (%s) %s"), *select, *Query.Query, *orderBy);
+		pagedQuery->NextPageQuery = FString::Printf(TEXT("%s WHERE (%s) AND %s %s"), *select, *Query.Query, *seek, *orderBy);
+	}
+	else
+	{
+		pagedQuery->FirstPageQuery = FString::Printf(TEXT("%s %s"), *select, *orderBy);
+		pagedQuery->NextPageQuery = FString::Printf(TEXT("%s WHERE %s %s"), *select, *seek, *orderBy);
+	}
+	return pagedQuery;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+FSQLiteQueryResult USQLitePagedQuery::NextPage()
+{
+	FSQLiteQueryResult result;
+	result.Success = true;
+	if (!bHasMorePages)
+	{
+		return result;
+	}
+
+	const bool firstPage = LastKey.IsNull();
+	FSQLiteRowCursor cursor;
+	if (!cursor.Open(Database, firstPage ? FirstPageQuery : NextPageQuery))
+	{
+		result.Success = false;
+		result.ErrorMessage = USQLiteDatabase::IsDatabaseHandleValid(Database)
+			? "SQL error: " + cursor.GetErrorMessage() : FString(TEXT("Database not registered"));
+		return result;
+	}
+
+	FSQLiteStatement& statement = cursor.GetStatement();
+	statement.Bind(statement.GetParameterIndex(TEXT(":PageSize")), (int64)PageSize);
+	if (!firstPage)
+	{
+		statement.Bind(statement.GetParameterIndex(TEXT(":PageKey")), LastKey);
+	}
+
+	const FSQLiteColumnsPtr columns = cursor.GetColumns();
+	if (!columns.IsValid())
+	{
+		result.Success = false;
+		result.ErrorMessage = TEXT("The query could not be prepared");
+		return result;
+	}
+	const int32 keyColumn = columns->Num() - 1;
+	result.SetColumns(*columns);
+	result.ColumnIndices.Remove(PageKeyAlias);
+	result.ResultRows.Reserve(PageSize);
+
+	// Only taken over once the whole page was read, a failed page is read again from the same key
+	FSQLiteValue pageLastKey;
+	for (const FSQLiteRowCursor& row : cursor)
+	{
+		FSQLiteQueryResultRow& outRow = result.ResultRows.AddDefaulted_GetRef();
+		USQLiteDatabase::ReadBlueprintRow(row.GetStatement().Get(), *columns, outRow);
+		outRow.Fields.Pop(false);
+		pageLastKey = row.GetValue(keyColumn);
+	}
+
+	if (cursor.HasError())
+	{
+		result.Success = false;
+		result.ErrorMessage = "SQL error: " + cursor.GetErrorMessage();
+		result.ResultRows.Empty();
+		return result;
+	}
+
+	if (result.ResultRows.Num() > 0)
+	{
+		LastKey = MoveTemp(pageLastKey);
+	}
+	bHasMorePages = result.ResultRows.Num() == PageSize;
+	return result;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+void USQLitePagedQuery::Rewind()
+{
+	LastKey = FSQLiteValue();
+	bHasMorePages = true;
+}
+
+void USQLitePagedQuery::SeekAfter(const FSQLiteValue& Key)
+{
+	LastKey = Key;
+	bHasMorePages = true;
+}
@@ -0,0 +1,163 @@
+#include "SQLitePreparedStatement.h"
+#include "CISQLite3PrivatePCH.h"
+
+//--------------------------------------------------------------------------------------------------------------
+
+USQLitePreparedStatement* USQLitePreparedStatement::CreatePreparedStatement(const FString& DatabaseName, const FString& Query)
+{
+	USQLitePreparedStatement* preparedStatement = NewObject<USQLitePreparedStatement>();
+	if (!preparedStatement->Statement.Prepare(DatabaseName, Query))
+	{
+		return nullptr;
+	}
+	// Statements kept in Blueprint variables hold no connection until they are stepped
+	preparedStatement->Statement.ReleaseConnection();
+	return preparedStatement;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+void USQLitePreparedStatement::Finalize()
+{
+	Statement.Finalize();
+}
+
+void USQLitePreparedStatement::BeginDestroy()
+{
+	Statement.Finalize();
+	Super::BeginDestroy();
+}
+
+bool USQLitePreparedStatement::IsPrepared() const
+{
+	return Statement.IsValid();
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+int32 USQLitePreparedStatement::GetParameterIndex(const FString& Name) const
+{
+	return Statement.GetParameterIndex(Name);
+}
+
+bool USQLitePreparedStatement::BindInteger(int32 Index, int64 Value)
+{
+	return Statement.Bind(Index, Value);
+}
+
+bool USQLitePreparedStatement::BindFloat(int32 Index, double Value)
+{
+	return Statement.Bind(Index, Value);
+}
+
+bool USQLitePreparedStatement::BindString(int32 Index, const FString& Value)
+{
+	return Statement.Bind(Index, Value);
+}
+
+bool USQLitePreparedStatement::BindBytes(int32 Index, const TArray<uint8>& Value)
+{
+	return Statement.Bind(Index, Value);
+}
+
+bool USQLitePreparedStatement::BindNull(int32 Index)
+{
+	return Statement.BindNull(Index);
+}
+
+bool USQLitePreparedStatement::ClearBindings()
+{
+	return Statement.ClearBindings();
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+bool USQLitePreparedStatement::Step()
+{
+	return Statement.Step();
+}
+
+bool USQLitePreparedStatement::Reset()
+{
+	return Statement.Reset();
+}
+
+bool USQLitePreparedStatement::Execute()
+{
+	while (Statement.Step()) {}
+	const bool success = Statement.IsDone();
+	Statement.Reset();
+	return success;
+}
+
+FSQLiteQueryResult USQLitePreparedStatement::ExecuteQuery()
+{
+	FSQLiteQueryResult result;
+	FSQLiteColumnsPtr columns;
+	while (Statement.Step())
+	{
+		if (!columns.IsValid())
+		{
+			columns = Statement.GetColumns();
+			result.SetColumns(*columns);
+		}
+		USQLiteDatabase::ReadBlueprintRow(Statement.Get(), *columns, result.ResultRows.AddDefaulted_GetRef());
+	}
+
+	result.Success = Statement.IsDone();
+	if (!result.Success)
+	{
+		result.ErrorMessage = Statement.GetErrorMessage();
+	}
+	Statement.Reset();
+	return result;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+int32 USQLitePreparedStatement::GetColumnCount() const
+{
+	return Statement.GetColumnCount();
+}
+
+FString USQLitePreparedStatement::GetColumnName(int32 Column) const
+{
+	return Statement.GetColumnName(Column);
+}
+
+bool USQLitePreparedStatement::IsColumnNull(int32 Column) const
+{
+	return Statement.GetColumnType(Column) == SQLITE_NULL;
+}
+
+int64 USQLitePreparedStatement::GetColumnInteger(int32 Column) const
+{
+	return Statement.GetColumnInt64(Column);
+}
+
+double USQLitePreparedStatement::GetColumnFloat(int32 Column) const
+{
+	return Statement.GetColumnDouble(Column);
+}
+
+FString USQLitePreparedStatement::GetColumnString(int32 Column) const
+{
+	return Statement.GetColumnString(Column);
+}
+
+TArray<uint8> USQLitePreparedStatement::GetColumnBytes(int32 Column) const
+{
+	return Statement.GetColumnBlob(Column);
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+int64 USQLitePreparedStatement::GetLastInsertRowId() const
+{
+	return Statement.GetLastInsertRowId();
+}
+
+int32 USQLitePreparedStatement::GetChanges() const
+{
+	return Statement.GetChanges();
+}
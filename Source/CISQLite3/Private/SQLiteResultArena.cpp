@@ -0,0 +1,114 @@
+#include "SQLiteResultArena.h"
+#include "CISQLite3PrivatePCH.h"
+
+//--------------------------------------------------------------------------------------------------------------
+
+FSQLiteResultArena::FSQLiteResultArena(int32 InBlockSize)
+	: BlockSize(FMath::Max(InBlockSize, 1024))
+{
+}
+
+FSQLiteResultArena::~FSQLiteResultArena()
+{
+	Empty();
+}
+
+FSQLiteResultArena::FSQLiteResultArena(FSQLiteResultArena&& Other)
+	: Blocks(MoveTemp(Other.Blocks))
+	, CurrentBlock(Other.CurrentBlock)
+	, Offset(Other.Offset)
+	, BlockSize(Other.BlockSize)
+{
+	Other.Blocks.Reset();
+	Other.CurrentBlock = INDEX_NONE;
+	Other.Offset = 0;
+}
+
+FSQLiteResultArena& FSQLiteResultArena::operator=(FSQLiteResultArena&& Other)
+{
+	if (this != &Other)
+	{
+		Empty();
+		Blocks = MoveTemp(Other.Blocks);
+		CurrentBlock = Other.CurrentBlock;
+		Offset = Other.Offset;
+		BlockSize = Other.BlockSize;
+		Other.Blocks.Reset();
+		Other.CurrentBlock = INDEX_NONE;
+		Other.Offset = 0;
+	}
+	return *this;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+void* FSQLiteResultArena::Allocate(SIZE_T Size, SIZE_T Alignment)
+{
+	if (CurrentBlock != INDEX_NONE)
+	{
+		const SIZE_T start = Align(Offset, Alignment);
+		if (start + Size <= Blocks[CurrentBlock].Size)
+		{
+			Offset = start + Size;
+			return Blocks[CurrentBlock].Data + start;
+		}
+	}
+
+	// Blocks are allocated with at least the alignment of any value type, so a fresh block needs no padding
+	const SIZE_T needed = Size + (Alignment > DEFAULT_ALIGNMENT ? Alignment : 0);
+	const int32 nextBlock = CurrentBlock + 1;
+	if (!Blocks.IsValidIndex(nextBlock) || Blocks[nextBlock].Size < needed)
+	{
+		// A block kept from before the last Reset() that is too small stays for later
+		FBlock block;
+		block.Size = FMath::Max<SIZE_T>(BlockSize, needed);
+		block.Data = static_cast<uint8*>(FMemory::Malloc(block.Size, DEFAULT_ALIGNMENT));
+		Blocks.Insert(block, nextBlock);
+	}
+
+	CurrentBlock = nextBlock;
+	const SIZE_T start = Align(reinterpret_cast<UPTRINT>(Blocks[CurrentBlock].Data), Alignment) - reinterpret_cast<UPTRINT>(Blocks[CurrentBlock].Data);
+	Offset = start + Size;
+	return Blocks[CurrentBlock].Data + start;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+void FSQLiteResultArena::Reset()
+{
+	CurrentBlock = INDEX_NONE;
+	Offset = 0;
+}
+
+void FSQLiteResultArena::Empty()
+{
+	for (const FBlock& block : Blocks)
+	{
+		FMemory::Free(block.Data);
+	}
+	Blocks.Empty();
+	CurrentBlock = INDEX_NONE;
+	Offset = 0;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+SIZE_T FSQLiteResultArena::GetUsedSize() const
+{
+	SIZE_T size = 0;
+	for (int32 i = 0; i < CurrentBlock; i++)
+	{
+		size += Blocks[i].Size;
+	}
+	return size + Offset;
+}
+
+SIZE_T FSQLiteResultArena::GetAllocatedSize() const
+{
+	SIZE_T size = Blocks.GetAllocatedSize();
+	for (const FBlock& block : Blocks)
+	{
+		size += block.Size;
+	}
+	return size;
+}
@@ -0,0 +1,88 @@
+#include "SQLiteRowCursor.h"
+#include "CISQLite3PrivatePCH.h"
+
+//--------------------------------------------------------------------------------------------------------------
+
+bool FSQLiteRowCursor::Open(const FString& DatabaseName, const FString& Query)
+{
+	return Open(USQLiteDatabase::GetDatabaseHandle(DatabaseName), Query);
+}
+
+bool FSQLiteRowCursor::Open(FSQLiteDatabaseHandle Database, const FString& Query)
+{
+	bStarted = false;
+	bHasRow = false;
+	return Statement.Prepare(Database, Query);
+}
+
+void FSQLiteRowCursor::Close()
+{
+	Statement.Finalize();
+	bStarted = false;
+	bHasRow = false;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+bool FSQLiteRowCursor::Next()
+{
+	// Stepping again after SQLITE_DONE would restart the statement
+	if (bStarted && !bHasRow)
+	{
+		return false;
+	}
+	bStarted = true;
+	bHasRow = Statement.Step();
+	return bHasRow;
+}
+
+FSQLiteRowCursor::FIterator FSQLiteRowCursor::begin()
+{
+	if (!bStarted)
+	{
+		Next();
+	}
+	return FIterator(bHasRow ? this : nullptr);
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+int32 FSQLiteRowCursor::FindColumn(const FString& Name) const
+{
+	const FSQLiteColumnsPtr columns = GetColumns();
+	if (!columns.IsValid())
+	{
+		return INDEX_NONE;
+	}
+	return columns->IndexOfByPredicate([&Name](const FSQLiteColumnInfo& Column) { return Column.Name == Name; });
+}
+
+FSQLiteValue FSQLiteRowCursor::GetValue(int32 Column) const
+{
+	FSQLiteValue value;
+	switch (GetColumnType(Column))
+	{
+	case SQLITE_INTEGER:
+		value.Type = ESQLiteValueType::Integer;
+		value.IntegerValue = GetInt64(Column);
+		break;
+	case SQLITE_FLOAT:
+		value.Type = ESQLiteValueType::Float;
+		value.FloatValue = GetDouble(Column);
+		break;
+	case SQLITE_TEXT:
+		value.Type = ESQLiteValueType::Text;
+		value.TextValue = GetText(Column);
+		break;
+	case SQLITE_BLOB:
+	{
+		value.Type = ESQLiteValueType::Blob;
+		const TConstArrayView<uint8> bytes = GetBytes(Column);
+		value.BlobValue.Append(bytes.GetData(), bytes.Num());
+		break;
+	}
+	default:
+		break;
+	}
+	return value;
+}
@@ -0,0 +1,404 @@
+#include "SQLiteStatement.h"
+#include "CISQLite3PrivatePCH.h"
+
+#define LOGSQLITE(verbosity, text) UE_LOG(LogDatabase, verbosity, TEXT("SQLite: %s"), text)
+
+//--------------------------------------------------------------------------------------------------------------
+
+FSQLiteStatement& FSQLiteStatement::operator=(FSQLiteStatement&& Other)
+{
+	if (this != &Other)
+	{
+		Finalize();
+		Database = Other.Database;
+		Query = MoveTemp(Other.Query);
+		Columns = MoveTemp(Other.Columns);
+		ParameterNames = MoveTemp(Other.ParameterNames);
+		Parameters = MoveTemp(Other.Parameters);
+		Connection = MoveTemp(Other.Connection);
+		Statement = MoveTemp(Other.Statement);
+		LastResultCode = Other.LastResultCode;
+		LastInsertRowId = Other.LastInsertRowId;
+		Changes = Other.Changes;
+		ErrorMessage = MoveTemp(Other.ErrorMessage);
+	}
+	return *this;
+}
+
+FSQLiteStatement::~FSQLiteStatement()
+{
+	Finalize();
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+bool FSQLiteStatement::Prepare(const FString& DatabaseName, const FString& InQuery)
+{
+	return Prepare(USQLiteDatabase::GetDatabaseHandle(DatabaseName), InQuery);
+}
+
+bool FSQLiteStatement::Prepare(FSQLiteDatabaseHandle InDatabase, const FString& InQuery)
+{
+	Finalize();
+
+	LastResultCode = USQLiteDatabase::PrepareQuery(InDatabase, InQuery, Connection, Statement);
+	if (!Connection.IsValid())
+	{
+		return false;
+	}
+
+	if (LastResultCode != SQLITE_OK || !Statement.IsValid())
+	{
+		// Kept past giving the connection back, so callers can report why
+		const int32 resultCode = LastResultCode != SQLITE_OK ? LastResultCode : SQLITE_ERROR;
+		const FString errorMessage = LastResultCode != SQLITE_OK ? GetErrorMessage() : FString(TEXT("The query has no statement"));
+		LOGSQLITE(Error, *FString::Printf(TEXT("Could not prepare statement: %s"), *errorMessage));
+		LOGSQLITE(Error, *FString::Printf(TEXT("The attempted query was: %s"), *InQuery));
+		Finalize();
+		LastResultCode = resultCode;
+		ErrorMessage = errorMessage;
+		return false;
+	}
+
+	if (Statement.HasTail())
+	{
+		LOGSQLITE(Warning, *FString::Printf(TEXT("Only the first statement of the query is prepared: %s"), *InQuery));
+	}
+
+	Database = InDatabase;
+	Query = InQuery;
+	Columns = Statement.GetColumns();
+
+	// Kept, so parameters can be looked up and bound while no connection is borrowed
+	const int32 parameterCount = sqlite3_bind_parameter_count(Statement.Get());
+	ParameterNames.SetNum(parameterCount);
+	Parameters.SetNum(parameterCount);
+	for (int32 p = 0; p < parameterCount; p++)
+	{
+		if (const char* name = sqlite3_bind_parameter_name(Statement.Get(), p + 1))
+		{
+			ParameterNames[p] = UTF8_TO_TCHAR(name);
+		}
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+void FSQLiteStatement::Finalize()
+{
+	Statement.Release();
+	Connection.Release();
+	Query.Empty();
+	Columns.Reset();
+	ParameterNames.Empty();
+	Parameters.Empty();
+	LastInsertRowId = 0;
+	Changes = 0;
+	ErrorMessage.Empty();
+}
+
+void FSQLiteStatement::ReleaseConnection()
+{
+	Detach();
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+bool FSQLiteStatement::Attach()
+{
+	LastResultCode = USQLiteDatabase::PrepareQuery(Database, Query, Connection, Statement);
+	if (LastResultCode != SQLITE_OK || !Statement.IsValid())
+	{
+		ErrorMessage = Connection.IsValid() ? FString(UTF8_TO_TCHAR(sqlite3_errmsg(Connection.GetDb()))) : FString(TEXT("No connection"));
+		LOGSQLITE(Error, *FString::Printf(TEXT("Could not prepare statement again: %s"), *ErrorMessage));
+		LOGSQLITE(Error, *FString::Printf(TEXT("The attempted query was: %s"), *Query));
+		Statement.Release();
+		Connection.Release();
+		if (LastResultCode == SQLITE_OK)
+		{
+			LastResultCode = SQLITE_ERROR;
+		}
+		return false;
+	}
+
+	// sqlite may have re-prepared it after a schema change since
+	Columns = Statement.GetColumns();
+
+	for (int32 p = 0; p < Parameters.Num(); p++)
+	{
+		// Unbound and NULL parameters are the same to sqlite
+		if (Parameters[p].Type != ESQLiteValueType::Null && !CheckBind(p + 1, BindValue(p + 1, Parameters[p])))
+		{
+			Detach();
+			return false;
+		}
+	}
+	return true;
+}
+
+void FSQLiteStatement::Detach()
+{
+	if (Connection.IsValid())
+	{
+		sqlite3* db = Connection.GetDb();
+		LastInsertRowId = sqlite3_last_insert_rowid(db);
+		Changes = sqlite3_changes(db);
+		ErrorMessage = UTF8_TO_TCHAR(sqlite3_errmsg(db));
+	}
+	Statement.Release();
+	Connection.Release();
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+int32 FSQLiteStatement::GetParameterCount() const
+{
+	return Parameters.Num();
+}
+
+int32 FSQLiteStatement::GetParameterIndex(const FString& Name) const
+{
+	// INDEX_NONE + 1 is 0, the "no such parameter" of sqlite
+	return ParameterNames.IndexOfByPredicate([&Name](const FString& Parameter) { return Parameter.Equals(Name, ESearchCase::CaseSensitive); }) + 1;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+bool FSQLiteStatement::CheckBind(int32 Index, int32 ResultCode)
+{
+	LastResultCode = ResultCode;
+	if (ResultCode != SQLITE_OK)
+	{
+		const FString message = Connection.IsValid() ? GetErrorMessage() : FString(UTF8_TO_TCHAR(sqlite3_errstr(ResultCode)));
+		LOGSQLITE(Error, *FString::Printf(TEXT("Could not bind parameter %d: %s"), Index, *message));
+		return false;
+	}
+	return true;
+}
+
+int32 FSQLiteStatement::BindValue(sqlite3_stmt* RawStatement, int32 Index, const FSQLiteValue& Value)
+{
+	switch (Value.Type)
+	{
+	case ESQLiteValueType::Integer:
+		return sqlite3_bind_int64(RawStatement, Index, Value.IntegerValue);
+	case ESQLiteValueType::Float:
+		return sqlite3_bind_double(RawStatement, Index, Value.FloatValue);
+	case ESQLiteValueType::Text:
+	{
+		const FTCHARToUTF8 utf8Value(*Value.TextValue);
+		return sqlite3_bind_text(RawStatement, Index, utf8Value.Get(), utf8Value.Length(), SQLITE_TRANSIENT);
+	}
+	case ESQLiteValueType::Blob:
+	{
+		// A null pointer would bind NULL instead of an empty blob
+		static const uint8 emptyBlob = 0;
+		const void* data = Value.BlobValue.Num() > 0 ? Value.BlobValue.GetData() : &emptyBlob;
+		return sqlite3_bind_blob(RawStatement, Index, data, Value.BlobValue.Num(), SQLITE_TRANSIENT);
+	}
+	default:
+		return sqlite3_bind_null(RawStatement, Index);
+	}
+}
+
+bool FSQLiteStatement::Bind(int32 Index, int32 Value)
+{
+	return Bind(Index, (int64)Value);
+}
+
+bool FSQLiteStatement::Bind(int32 Index, int64 Value)
+{
+	FSQLiteValue value;
+	value.Type = ESQLiteValueType::Integer;
+	value.IntegerValue = Value;
+	return Bind(Index, value);
+}
+
+bool FSQLiteStatement::Bind(int32 Index, double Value)
+{
+	FSQLiteValue value;
+	value.Type = ESQLiteValueType::Float;
+	value.FloatValue = Value;
+	return Bind(Index, value);
+}
+
+bool FSQLiteStatement::Bind(int32 Index, const FString& Value)
+{
+	FSQLiteValue value;
+	value.Type = ESQLiteValueType::Text;
+	value.TextValue = Value;
+	return Bind(Index, value);
+}
+
+bool FSQLiteStatement::Bind(int32 Index, const TArray<uint8>& Value)
+{
+	FSQLiteValue value;
+	value.Type = ESQLiteValueType::Blob;
+	value.BlobValue = Value;
+	return Bind(Index, value);
+}
+
+bool FSQLiteStatement::Bind(int32 Index, const FSQLiteValue& Value)
+{
+	if (!IsValid())
+	{
+		return false;
+	}
+	if (!Parameters.IsValidIndex(Index - 1))
+	{
+		return CheckBind(Index, SQLITE_RANGE);
+	}
+	Parameters[Index - 1] = Value;
+	// Without a connection it's bound when the statement runs next
+	return !Statement.IsValid() || CheckBind(Index, BindValue(Index, Value));
+}
+
+bool FSQLiteStatement::BindNull(int32 Index)
+{
+	return Bind(Index, FSQLiteValue());
+}
+
+bool FSQLiteStatement::ClearBindings()
+{
+	if (!IsValid())
+	{
+		return false;
+	}
+	for (FSQLiteValue& parameter : Parameters)
+	{
+		parameter = FSQLiteValue();
+	}
+	return !Statement.IsValid() || sqlite3_clear_bindings(Statement.Get()) == SQLITE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+bool FSQLiteStatement::Step()
+{
+	if (!IsValid() || (!Statement.IsValid() && !Attach()))
+	{
+		return false;
+	}
+
+	LastResultCode = sqlite3_step(Statement.Get());
+	if (LastResultCode == SQLITE_ROW)
+	{
+		return true;
+	}
+	if (LastResultCode != SQLITE_DONE)
+	{
+		LOGSQLITE(Error, *FString::Printf(TEXT("Statement failed: %s"), *GetErrorMessage()));
+		LOGSQLITE(Error, *FString::Printf(TEXT("The attempted query was: %s"), *Query));
+	}
+	// Done or failed, the connection isn't needed until the next run
+	Detach();
+	return false;
+}
+
+bool FSQLiteStatement::Reset()
+{
+	if (!IsValid())
+	{
+		return false;
+	}
+	// Returning the statement to its cache resets it. sqlite3_reset repeats the error of the last step,
+	// which was already reported there
+	Detach();
+	LastResultCode = SQLITE_OK;
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+int32 FSQLiteStatement::GetColumnCount() const
+{
+	return Columns.IsValid() ? Columns->Num() : 0;
+}
+
+FString FSQLiteStatement::GetColumnName(int32 Column) const
+{
+	return Columns.IsValid() && Columns->IsValidIndex(Column) ? (*Columns)[Column].Name : FString();
+}
+
+FSQLiteColumnsPtr FSQLiteStatement::GetColumns() const
+{
+	// While it runs the statement may have been re-prepared by its last step, the cache notices
+	return Statement.IsValid() ? Statement.GetColumns() : Columns;
+}
+
+int32 FSQLiteStatement::GetColumnType(int32 Column) const
+{
+	return Statement.IsValid() ? sqlite3_column_type(Statement.Get(), Column) : SQLITE_NULL;
+}
+
+int64 FSQLiteStatement::GetColumnInt64(int32 Column) const
+{
+	return Statement.IsValid() ? sqlite3_column_int64(Statement.Get(), Column) : 0;
+}
+
+double FSQLiteStatement::GetColumnDouble(int32 Column) const
+{
+	return Statement.IsValid() ? sqlite3_column_double(Statement.Get(), Column) : 0.0;
+}
+
+FString FSQLiteStatement::GetColumnString(int32 Column) const
+{
+	if (!Statement.IsValid())
+	{
+		return FString();
+	}
+	const char* text = reinterpret_cast<const char*>(sqlite3_column_text(Statement.Get(), Column));
+	const int32 length = sqlite3_column_bytes(Statement.Get(), Column);
+	if (!text)
+	{
+		return FString();
+	}
+	const FUTF8ToTCHAR converted(text, length);
+	return FString(converted.Length(), converted.Get());
+}
+
+TArray<uint8> FSQLiteStatement::GetColumnBlob(int32 Column) const
+{
+	if (!Statement.IsValid())
+	{
+		return TArray<uint8>();
+	}
+	const TConstArrayView<uint8> bytes = GetColumnBytes(Column);
+	return TArray<uint8>(bytes.GetData(), bytes.Num());
+}
+
+TConstArrayView<uint8> FSQLiteStatement::GetColumnBytes(int32 Column) const
+{
+	if (!Statement.IsValid())
+	{
+		return TConstArrayView<uint8>();
+	}
+	// sqlite3_column_bytes has to come after the pointer, it reports the length of the converted value
+	const void* data = sqlite3_column_type(Statement.Get(), Column) == SQLITE_BLOB
+		? sqlite3_column_blob(Statement.Get(), Column)
+		: sqlite3_column_text(Statement.Get(), Column);
+	const int32 length = sqlite3_column_bytes(Statement.Get(), Column);
+	return data ? TConstArrayView<uint8>(static_cast<const uint8*>(data), length) : TConstArrayView<uint8>();
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+int64 FSQLiteStatement::GetLastInsertRowId() const
+{
+	return Connection.IsValid() ? sqlite3_last_insert_rowid(Connection.GetDb()) : LastInsertRowId;
+}
+
+int32 FSQLiteStatement::GetChanges() const
+{
+	return Connection.IsValid() ? sqlite3_changes(Connection.GetDb()) : Changes;
+}
+
+FString FSQLiteStatement::GetErrorMessage() const
+{
+	if (Connection.IsValid())
+	{
+		return UTF8_TO_TCHAR(sqlite3_errmsg(Connection.GetDb()));
+	}
+	return ErrorMessage.IsEmpty() ? FString(TEXT("No connection")) : ErrorMessage;
+}
@@ -0,0 +1,261 @@
+#include "SQLiteStatementCache.h"
+#include "CISQLite3PrivatePCH.h"
+
+//--------------------------------------------------------------------------------------------------------------
+
+FSQLiteCachedStatement::FSQLiteCachedStatement(FSQLiteCachedStatement&& Other)
+	: Cache(Other.Cache)
+	, EntryIndex(Other.EntryIndex)
+	, Statement(Other.Statement)
+	, bHasTail(Other.bHasTail)
+	, UncachedColumns(MoveTemp(Other.UncachedColumns))
+	, UncachedColumnsReprepares(Other.UncachedColumnsReprepares)
+{
+	Other.Cache = nullptr;
+	Other.EntryIndex = INDEX_NONE;
+	Other.Statement = nullptr;
+	Other.bHasTail = false;
+}
+
+FSQLiteCachedStatement& FSQLiteCachedStatement::operator=(FSQLiteCachedStatement&& Other)
+{
+	if (this != &Other)
+	{
+		Release();
+		Cache = Other.Cache;
+		EntryIndex = Other.EntryIndex;
+		Statement = Other.Statement;
+		bHasTail = Other.bHasTail;
+		UncachedColumns = MoveTemp(Other.UncachedColumns);
+		UncachedColumnsReprepares = Other.UncachedColumnsReprepares;
+		Other.Cache = nullptr;
+		Other.EntryIndex = INDEX_NONE;
+		Other.Statement = nullptr;
+		Other.bHasTail = false;
+	}
+	return *this;
+}
+
+FSQLiteCachedStatement::~FSQLiteCachedStatement()
+{
+	Release();
+}
+
+void FSQLiteCachedStatement::Release()
+{
+	if (Cache)
+	{
+		Cache->Release(EntryIndex);
+	}
+	else if (Statement)
+	{
+		sqlite3_finalize(Statement);
+	}
+	Cache = nullptr;
+	EntryIndex = INDEX_NONE;
+	Statement = nullptr;
+	bHasTail = false;
+	UncachedColumns.Reset();
+	UncachedColumnsReprepares = 0;
+}
+
+FSQLiteColumnsPtr FSQLiteCachedStatement::GetColumns() const
+{
+	if (Cache)
+	{
+		return Cache->GetColumns(EntryIndex);
+	}
+	if (!Statement)
+	{
+		return UncachedColumns;
+	}
+	// sqlite re-prepares statements after schema changes, "SELECT *" may then return other columns
+	const int32 reprepares = sqlite3_stmt_status(Statement, SQLITE_STMTSTATUS_REPREPARE, 0);
+	if (!UncachedColumns.IsValid() || UncachedColumnsReprepares != reprepares)
+	{
+		UncachedColumns = FSQLiteStatementCache::ResolveColumns(Statement);
+		UncachedColumnsReprepares = reprepares;
+	}
+	return UncachedColumns;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+FSQLiteStatementCache::FSQLiteStatementCache(sqlite3* InDb, int32 InCapacity, FSQLiteStatementCacheCounters& InCounters)
+	: Db(InDb)
+	, Capacity(FMath::Max(InCapacity, 0))
+	, Counters(InCounters)
+{
+	SeenQueries.SetNumZeroed(Capacity * 4);
+}
+
+FSQLiteStatementCache::~FSQLiteStatementCache()
+{
+	Empty();
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+int32 FSQLiteStatementCache::Acquire(const FString& Query, FSQLiteCachedStatement& OutStatement)
+{
+	OutStatement.Release();
+
+	const int32* existing = Index.Find(Query);
+	if (existing && !Entries[*existing].bInUse)
+	{
+		FEntry& entry = Entries[*existing];
+		entry.bInUse = true;
+		entry.LastUsed = ++UseCounter;
+		Counters.Hits++;
+
+		OutStatement.Cache = this;
+		OutStatement.EntryIndex = *existing;
+		OutStatement.Statement = entry.Statement;
+		OutStatement.bHasTail = entry.bHasTail;
+		return SQLITE_OK;
+	}
+
+	// Statements that are already handed out (nested use of the same query) are prepared once more, uncached
+	bool cacheable = Capacity > 0 && !existing;
+	if (cacheable)
+	{
+		const uint32 queryHash = FCrc::StrCrc32(*Query);
+		uint64& seen = SeenQueries[queryHash % SeenQueries.Num()];
+		cacheable = seen == (uint64)queryHash + 1;
+		seen = (uint64)queryHash + 1;
+	}
+
+	// The slot is picked before preparing, with every statement handed out the query isn't cached either
+	int32 slot = INDEX_NONE;
+	if (cacheable && Entries.Num() >= Capacity)
+	{
+		// Evict the least recently used statement that isn't handed out
+		for (int32 i = 0; i < Entries.Num(); i++)
+		{
+			if (!Entries[i].bInUse && (slot == INDEX_NONE || Entries[i].LastUsed < Entries[slot].LastUsed))
+			{
+				slot = i;
+			}
+		}
+		cacheable = slot != INDEX_NONE;
+	}
+
+	const FTCHARToUTF8 utf8Query(*Query);
+	sqlite3_stmt* statement = nullptr;
+	const char* tail = nullptr;
+	const int32 result = sqlite3_prepare_v3(Db, utf8Query.Get(), utf8Query.Length() + 1,
+		cacheable ? SQLITE_PREPARE_PERSISTENT : 0, &statement, &tail);
+	if (result != SQLITE_OK || !statement)
+	{
+		sqlite3_finalize(statement);
+		return result;
+	}
+
+	bool hasTail = false;
+	for (; tail && *tail; ++tail)
+	{
+		if (!FCharAnsi::IsWhitespace(*tail) && *tail != ';')
+		{
+			hasTail = true;
+			break;
+		}
+	}
+
+	OutStatement.Statement = statement;
+	OutStatement.bHasTail = hasTail;
+
+	// Several statements in one text are run through sqlite3_exec anyway
+	if (!cacheable || hasTail)
+	{
+		Counters.Uncached++;
+		return SQLITE_OK;
+	}
+	Counters.Misses++;
+
+	if (slot == INDEX_NONE)
+	{
+		slot = Entries.AddDefaulted();
+	}
+	else
+	{
+		FEntry& evicted = Entries[slot];
+		Index.Remove(evicted.Sql);
+		sqlite3_finalize(evicted.Statement);
+		Counters.Evictions++;
+	}
+
+	FEntry& entry = Entries[slot];
+	entry.Sql = Query;
+	entry.Statement = statement;
+	entry.Columns.Reset();
+	entry.LastUsed = ++UseCounter;
+	entry.bInUse = true;
+	entry.bHasTail = hasTail;
+	Index.Add(Query, slot);
+
+	OutStatement.Cache = this;
+	OutStatement.EntryIndex = slot;
+	return SQLITE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+void FSQLiteStatementCache::Release(int32 EntryIndex)
+{
+	FEntry& entry = Entries[EntryIndex];
+	sqlite3_reset(entry.Statement);
+	sqlite3_clear_bindings(entry.Statement);
+	entry.bInUse = false;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+FSQLiteColumnsPtr FSQLiteStatementCache::GetColumns(int32 EntryIndex)
+{
+	FEntry& entry = Entries[EntryIndex];
+	// sqlite re-prepares statements after schema changes, "SELECT *" may then return other columns, even
+	// as many as before but renamed or reordered. A new array also means new binding plans, they're keyed by it
+	const int32 reprepares = sqlite3_stmt_status(entry.Statement, SQLITE_STMTSTATUS_REPREPARE, 0);
+	if (!entry.Columns.IsValid() || entry.ColumnsReprepares != reprepares)
+	{
+		entry.Columns = ResolveColumns(entry.Statement);
+		entry.ColumnsReprepares = reprepares;
+	}
+	return entry.Columns;
+}
+
+FSQLiteColumnsPtr FSQLiteStatementCache::ResolveColumns(sqlite3_stmt* Statement)
+{
+	TSharedRef<FSQLiteColumns, ESPMode::ThreadSafe> columns = MakeShared<FSQLiteColumns, ESPMode::ThreadSafe>();
+	const int32 columnCount = sqlite3_column_count(Statement);
+	columns->SetNum(columnCount);
+	for (int32 c = 0; c < columnCount; c++)
+	{
+		FSQLiteColumnInfo& column = (*columns)[c];
+		column.Name = UTF8_TO_TCHAR(sqlite3_column_name(Statement, c));
+		if (const char* declaredType = sqlite3_column_decltype(Statement, c))
+		{
+			column.DeclaredType = UTF8_TO_TCHAR(declaredType);
+		}
+#ifdef SQLITE_ENABLE_COLUMN_METADATA
+		if (const char* originTable = sqlite3_column_table_name(Statement, c))
+		{
+			column.OriginTable = UTF8_TO_TCHAR(originTable);
+		}
+#endif
+	}
+	return columns;
+}
+
+//--------------------------------------------------------------------------------------------------------------
+
+void FSQLiteStatementCache::Empty()
+{
+	for (FEntry& entry : Entries)
+	{
+		check(!entry.bInUse);
+		sqlite3_finalize(entry.Statement);
+	}
+	Entries.Empty();
+	Index.Empty();
+}
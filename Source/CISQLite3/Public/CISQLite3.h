@@ -3,6 +3,7 @@
 #pragma once
 
 #include "Modules/ModuleManager.h"
+#include "Containers/Ticker.h"
 
 class FCISQLite3 : public IModuleInterface
 {
@@ -11,4 +12,8 @@ public:
   /** IModuleInterface implementation */
   virtual void StartupModule() override;
   virtual void ShutdownModule() override;
+
+private:
+  /** Closes idle database connections every now and then */
+  FTSTicker::FDelegateHandle PruneTickerHandle;
 };
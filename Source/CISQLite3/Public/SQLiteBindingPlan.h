@@ -0,0 +1,98 @@
+#pragma once
+#include "SQLiteStatementCache.h"
+#include "UObject/WeakObjectPtr.h"
+#include "Misc/ScopeRWLock.h"
+
+struct SQLiteResultValue;
+struct FSQLiteValue;
+
+/**
+* How the columns of a result map to the properties of a class or struct: for every column ordinal the property
+* with the column's name, its offset and how to write it. Made once per (struct, column layout) and cached, so
+* populating many objects from the same query is a loop over precomputed offsets, without looking up property
+* names or casting properties per cell.
+*
+* Plans are shared and immutable, and the cache is safe to use from any thread.
+*/
+class CISQLITE3_API FSQLiteBindingPlan
+{
+public:
+	enum class EKind : uint8
+	{
+		None,
+		Int64,
+		Int32,
+		Int16,
+		Int8,
+		Bool,
+		Double,
+		Float,
+		String,
+		Bytes
+	};
+
+	struct FBinding
+	{
+		EKind Kind = EKind::None;
+		/** Offset of the value in the container */
+		int32 Offset = 0;
+		/** Bools can be bitfields, they are written through the property */
+		const FBoolProperty* BoolProperty = nullptr;
+	};
+
+	/** The plan for writing rows with these columns into instances of Struct, taken from the cache or made now. */
+	static TSharedRef<const FSQLiteBindingPlan, ESPMode::ThreadSafe> Get(const UStruct* Struct, const FSQLiteColumnsPtr& Columns);
+
+	/** Writes a result row into an instance of the plan's struct (eg. a UObject of the class). Fields whose type
+	*   doesn't fit the property are skipped, same for NULLs. */
+	void Apply(const SQLiteResultValue& Row, void* Container) const;
+
+	/** Writes the current row of a statement stepped to SQLITE_ROW straight into an instance, without collecting it first. */
+	void Apply(sqlite3_stmt* Statement, void* Container) const;
+
+	/** The other way around: binds the bound members of an instance to the parameters 1 to GetNumBound() of a statement,
+	*   in column order. Returns the sqlite result code of the first bind that failed, or SQLITE_OK. */
+	int32 BindParameters(sqlite3_stmt* Statement, const void* Container) const;
+
+	/** Binds the member of one column to one parameter. */
+	int32 BindParameter(sqlite3_stmt* Statement, int32 Parameter, int32 Column, const void* Container) const;
+
+	/** Copies the member of one column into a value, Null if the column has no property. */
+	FSQLiteValue GetValue(int32 Column, const void* Container) const;
+
+	/** A compact fingerprint of every bound member of an instance, in column order: the value's bits for numbers,
+	*   a 64 bit hash for strings and bytes. Comparing fingerprints tells which members changed without keeping copies. */
+	void GetFingerprints(const void* Container, TArray<uint64>& OutFingerprints) const;
+
+	/** Whether any column has a property to go to. */
+	bool HasBindings() const { return NumBound > 0; }
+	/** Number of columns that have a property to go to. */
+	int32 GetNumBound() const { return NumBound; }
+
+	const FBinding& GetBinding(int32 Column) const { return Bindings[Column]; }
+	int32 Num() const { return Bindings.Num(); }
+
+private:
+	FSQLiteBindingPlan(const UStruct* Struct, const FSQLiteColumns& Columns);
+
+	/** A hash of the struct's size and of the address, type and offset of each of its properties. Recompiling a
+	*   Blueprint class or a user defined struct can keep the UStruct but changes its layout and properties. */
+	static uint64 GetLayoutSignature(const UStruct* Struct);
+
+	/** One entry per column ordinal */
+	TArray<FBinding> Bindings;
+	int32 NumBound = 0;
+
+	struct FCacheEntry
+	{
+		TWeakObjectPtr<const UStruct> Struct;
+		/** Column arrays are made once per prepared statement, a plan is valid as long as its array lives */
+		TWeakPtr<const FSQLiteColumns, ESPMode::ThreadSafe> Columns;
+		/** The plan points into the struct's properties, it's made again once their layout changed */
+		uint64 LayoutSignature = 0;
+		TSharedPtr<const FSQLiteBindingPlan, ESPMode::ThreadSafe> Plan;
+	};
+
+	static FRWLock CacheLock;
+	static TMap<TPair<const UStruct*, const FSQLiteColumns*>, FCacheEntry> Cache;
+};
@@ -1,6 +1,7 @@
 #pragma once
 #include "Kismet/BlueprintFunctionLibrary.h"
-//#include "SQLiteDatabase.h"
+#include "SQLiteDatabase.h"
+#include "SQLiteDatabaseStructs.h"
 #include "SQLiteBlueprintFunctionLibrary.generated.h"
 
 /**
@@ -22,6 +23,50 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category = "SQLite|Value Conversion")
 		static float CastToFloat(FString SQLiteResultValue);
+
+	/**
+	* Getters for typed values, converting between storage classes the way sqlite does. NULL reads as 0 or empty.
+	*/
+
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "Is Null (SQLite Value)"), Category = "SQLite|Value Conversion")
+		static bool IsValueNull(const FSQLiteValue& Value);
+
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "To Integer (SQLite Value)"), Category = "SQLite|Value Conversion")
+		static int32 ValueToInt(const FSQLiteValue& Value);
+
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "To Integer64 (SQLite Value)"), Category = "SQLite|Value Conversion")
+		static int64 ValueToInt64(const FSQLiteValue& Value);
+
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "To Float (SQLite Value)"), Category = "SQLite|Value Conversion")
+		static double ValueToFloat(const FSQLiteValue& Value);
+
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "To Boolean (SQLite Value)"), Category = "SQLite|Value Conversion")
+		static bool ValueToBoolean(const FSQLiteValue& Value);
+
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "To String (SQLite Value)"), Category = "SQLite|Value Conversion")
+		static FString ValueToString(const FSQLiteValue& Value);
+
+	/** Bytes of a BLOB, the UTF-8 bytes of TEXT, empty for other values. */
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "To Bytes (SQLite Value)"), Category = "SQLite|Value Conversion")
+		static TArray<uint8> ValueToBytes(const FSQLiteValue& Value);
+
+	/**
+	* Field access on query results. Look the column index up once, then read every row by index
+	* instead of comparing the field names of each row.
+	*/
+
+	/** Position of a column in each row's Fields, -1 if the result has no column with that name. */
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "Get Column Index"), Category = "SQLite|Query Result")
+		static int32 GetColumnIndex(const FSQLiteQueryResult& Result, const FString& ColumnName);
+
+	/** Value of a field by row and column index, empty if either is out of range. */
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "Get Field By Index"), Category = "SQLite|Query Result")
+		static FString GetFieldByIndex(const FSQLiteQueryResult& Result, int32 Row, int32 Column);
+
+	/** Value of a field by row and column name, empty if there is no such row or column. */
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "Get Field By Name"), Category = "SQLite|Query Result")
+		static FString GetFieldByName(const FSQLiteQueryResult& Result, int32 Row, const FString& ColumnName);
+
 	/**
 	* Blueprint nodes for building queries.
 	*/
@@ -68,6 +113,18 @@ public:
 	UFUNCTION(BlueprintPure, meta = (DisplayName = "Index (SQLite)"), Category = "SQLite|Query|DataTypes")
 		static FSQLiteIndex SQLiteIndexFunction(const TArray<FSQLiteTableField> Fields, FString idxName, bool Unique);
 
+	/** Connection profile for content shipped with the game: read-only, memory mapped, no syncing. */
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "Read Only Content Profile"), Category = "SQLite|Connection Profile")
+		static FSQLiteConnectionProfile SQLiteReadOnlyContentProfile();
+
+	/** Connection profile for save games: WAL with full syncing. */
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "Save Game Profile"), Category = "SQLite|Connection Profile")
+		static FSQLiteConnectionProfile SQLiteSaveGameProfile();
+
+	/** Connection profile for telemetry and logs: WAL without syncing. */
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "Telemetry Profile"), Category = "SQLite|Connection Profile")
+		static FSQLiteConnectionProfile SQLiteTelemetryProfile();
+
 
 
 };
@@ -0,0 +1,78 @@
+#pragma once
+#include "sqlite3.h"
+#include "Containers/ArrayView.h"
+#include "Containers/BitArray.h"
+
+/**
+* Query result stored column by column: one contiguous typed array per column plus a null bitmap,
+* column names stored once. Much smaller than SQLiteQueryResult for large results (no per-cell strings),
+* and scanning a single column walks one array.
+*
+* A column takes the storage class of its first non-NULL value. A column that later gets a value of a wider
+* class is converted: INTEGER -> FLOAT -> TEXT/BLOB. Integers above 2^53 lose precision when their column is
+* promoted to FLOAT, same as with sqlite's own conversion; FLOAT to TEXT uses sqlite's "%.15g".
+* TEXT and BLOB values are packed back to back into one byte array per column (text as UTF-8).
+*/
+class CISQLITE3_API FSQLiteColumnarResult
+{
+public:
+	bool Success = false;
+	FString ErrorMessage;
+
+	/** Sets up the columns of a freshly prepared statement, dropping all rows. */
+	void Reset(sqlite3_stmt* Statement);
+
+	/** Appends the current row of a statement that was stepped to SQLITE_ROW. */
+	void AddRow(sqlite3_stmt* Statement);
+
+	int32 Num() const { return NumRows; }
+	int32 NumColumns() const { return Columns.Num(); }
+
+	const FString& GetColumnName(int32 Column) const { return Columns[Column].Name; }
+	/** Index of the column with that name, INDEX_NONE if there is none. */
+	int32 FindColumn(const FString& Name) const;
+
+	/** SQLITE_INTEGER, SQLITE_FLOAT, SQLITE_TEXT or SQLITE_BLOB, SQLITE_NULL if all values are NULL. */
+	int32 GetColumnType(int32 Column) const { return Columns[Column].Type; }
+
+	bool IsNull(int32 Row, int32 Column) const { return Columns[Column].Nulls[Row]; }
+
+	/** Values converted the way sqlite3_column_* would, NULL reads as 0 or empty. */
+	int64 GetInt64(int32 Row, int32 Column) const;
+	double GetDouble(int32 Row, int32 Column) const;
+	FString GetString(int32 Row, int32 Column) const;
+
+	/** Raw bytes of a TEXT (UTF-8, not terminated) or BLOB column, empty for other columns. */
+	TConstArrayView<uint8> GetBytes(int32 Row, int32 Column) const;
+
+	/** All values of an INTEGER / FLOAT column, one per row (0 for NULLs), empty for other columns. */
+	TConstArrayView<int64> GetInt64Column(int32 Column) const { return Columns[Column].Integers; }
+	TConstArrayView<double> GetDoubleColumn(int32 Column) const { return Columns[Column].Floats; }
+
+	/** Heap memory held by the result. */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	struct FColumn
+	{
+		FString Name;
+		int32 Type = SQLITE_NULL;
+
+		/** Only the array matching Type is used */
+		TArray<int64> Integers;
+		TArray<double> Floats;
+
+		/** Row i's TEXT/BLOB bytes are Bytes[Offsets[i], Offsets[i + 1]) */
+		TArray<uint8> Bytes;
+		TArray<int32> Offsets;
+
+		TBitArray<> Nulls;
+	};
+
+	/** Converts the values stored so far to a wider storage class */
+	void Promote(FColumn& Column, int32 NewType) const;
+	static void AppendBytes(FColumn& Column, const void* Data, int32 Length);
+
+	TArray<FColumn> Columns;
+	int32 NumRows = 0;
+};
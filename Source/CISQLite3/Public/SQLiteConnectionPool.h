@@ -0,0 +1,221 @@
+#pragma once
+#include "sqlite3.h"
+#include "SQLiteDatabaseStructs.h"
+#include "SQLiteStatementCache.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/Event.h"
+#include "Misc/ScopeRWLock.h"
+#include "Templates/SharedPointer.h"
+#include "Templates/UniquePtr.h"
+#include <atomic>
+
+class FSQLiteConnectionPool;
+
+/**
+* A single open sqlite3 connection owned by a pool.
+*/
+class CISQLITE3_API FSQLiteConnection
+{
+public:
+	FSQLiteConnection(sqlite3* InDb, int32 StatementCacheSize, FSQLiteStatementCacheCounters& StatementCacheCounters);
+	~FSQLiteConnection();
+
+	sqlite3* GetDb() const { return Db; }
+	FSQLiteStatementCache& GetStatementCache() { return StatementCache; }
+
+	/** Connections open right now, over all databases. */
+	static int32 GetNumOpen() { return NumOpen.load(); }
+
+private:
+	friend class FSQLiteConnectionPool;
+
+	sqlite3* Db;
+
+	FSQLiteStatementCache StatementCache;
+
+	/** FPlatformTime::Seconds() of the last time the connection was returned to the pool,
+	*   for per-thread WAL readers the last time it was handed out */
+	double LastUsedTime;
+
+	static std::atomic<int32> NumOpen;
+};
+
+/**
+* Borrowed connection, returns itself to its pool when it goes out of scope.
+* Per-thread WAL readers are shared with later borrowers on the same thread instead.
+*/
+class CISQLITE3_API FSQLitePooledConnection
+{
+public:
+	FSQLitePooledConnection() = default;
+	FSQLitePooledConnection(TSharedRef<FSQLiteConnectionPool, ESPMode::ThreadSafe> InPool, TUniquePtr<FSQLiteConnection>&& InConnection);
+	FSQLitePooledConnection(TSharedRef<FSQLiteConnectionPool, ESPMode::ThreadSafe> InPool, TSharedRef<FSQLiteConnection, ESPMode::ThreadSafe> InThreadReader);
+	FSQLitePooledConnection(FSQLitePooledConnection&& Other) = default;
+	FSQLitePooledConnection& operator=(FSQLitePooledConnection&& Other);
+	~FSQLitePooledConnection();
+
+	FSQLitePooledConnection(const FSQLitePooledConnection&) = delete;
+	FSQLitePooledConnection& operator=(const FSQLitePooledConnection&) = delete;
+
+	bool IsValid() const { return GetConnection() != nullptr; }
+	sqlite3* GetDb() const { return IsValid() ? GetConnection()->GetDb() : nullptr; }
+	FSQLiteConnection* GetConnection() const { return Connection.IsValid() ? Connection.Get() : ThreadReader.Get(); }
+
+	/** Whether this is a read-only per-thread WAL reader connection. */
+	bool IsThreadReader() const { return ThreadReader.IsValid(); }
+
+	/** Returns the connection to the pool early. */
+	void Release();
+
+private:
+	TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe> Pool;
+	TUniquePtr<FSQLiteConnection> Connection;
+
+	/** Set instead of Connection for per-thread WAL readers, which are never returned */
+	TSharedPtr<FSQLiteConnection, ESPMode::ThreadSafe> ThreadReader;
+};
+
+/**
+* Keeps connections to one database file open between queries so that steady-state queries
+* never pay for sqlite3_open, schema parsing and a cold page cache.
+* Connections are handed out exclusively, so a borrowed connection is only used by one thread at a time.
+*
+* With PerThreadWalReaders the file is switched to WAL journaling, the pool keeps exactly one writer
+* connection and every thread that reads gets its own lazily opened read-only connection,
+* so readers on different threads neither wait for each other nor for the writer.
+*/
+class CISQLITE3_API FSQLiteConnectionPool : public TSharedFromThis<FSQLiteConnectionPool, ESPMode::ThreadSafe>
+{
+public:
+	FSQLiteConnectionPool(const FString& InFilename, const FSQLiteConnectionPoolSettings& InSettings,
+		const FSQLiteConnectionProfile& InProfile = FSQLiteConnectionProfile());
+	~FSQLiteConnectionPool();
+
+	/** Opens MinConnections connections (at least one, which stays idle until the first query or the idle timeout)
+	*   and validates the file on the first of them. Returns false if the database can't be opened or isn't one. */
+	bool Warmup();
+
+	/** Borrows a connection, opening a new one if none is idle and MaxConnections isn't reached yet.
+	*   Returns an invalid connection if the database couldn't be opened or the wait timed out.
+	*   A connection returned inside a transaction (after "BEGIN") stays with the thread that returned it and is the
+	*   one that thread gets from here on, until the transaction ends. So a transaction over several calls must begin
+	*   and end on the same thread, and other threads don't see it. */
+	FSQLitePooledConnection Acquire();
+
+	/** Borrows a connection for read-only statements: the calling thread's WAL reader if
+	*   PerThreadWalReaders is set, otherwise the same as Acquire(). */
+	FSQLitePooledConnection AcquireReader();
+
+	/** Closes all idle connections and refuses further borrowing. Borrowed connections are closed when returned. */
+	void Shutdown();
+
+	/** Closes idle connections (and per-thread WAL readers) that were unused longer than the idle timeout.
+	*   USQLiteDatabase calls this for every database from a ticker, so idle databases let go of their files. */
+	void PruneIdleConnections();
+
+	/** Soft cap on connections open over all databases, 0 for no cap. Opening a connection beyond the cap
+	*   first closes the least recently used idle connection of any database, above its MinConnections. */
+	static void SetMaxTotalConnections(int32 MaxConnections);
+	static int32 GetMaxTotalConnections() { return MaxTotalConnections.load(); }
+
+	/** Keeps only the given borrowed connection from now on, used when its "main" schema
+	*   was replaced in memory (sqlite3_deserialize) and other connections would not see the change. */
+	void PinConnection(const FSQLitePooledConnection& Connection);
+
+	/** Whether the file is a usable database. The file is only checked (stat + open + reading its header)
+	*   the first time and after RequestRevalidation(), otherwise this is the remembered answer. */
+	bool IsValidDatabase();
+
+	/** Makes the next IsValidDatabase() check the file again. Called when a connection hits an error
+	*   that points at the file (corrupt, not a database, I/O error, can't open) and when the file changes. */
+	void RequestRevalidation();
+
+	/** The file was modified or replaced on disk: drops idle connections so nobody keeps reading
+	*   the old file, and checks it again on the next IsValidDatabase(). */
+	void OnFileChanged();
+
+#if WITH_EDITOR
+	/** Calls OnFileChanged() when the editor's directory watcher reports a change of the file. */
+	void StartWatchingFile();
+	void StopWatchingFile();
+#endif
+
+	const FString& GetFilename() const { return Filename; }
+	const FSQLiteConnectionPoolSettings& GetSettings() const { return Settings; }
+	const FSQLiteConnectionProfile& GetProfile() const { return Profile; }
+	int32 GetNumOpenConnections() const;
+	FSQLiteStatementCacheStats GetStatementCacheStats() const;
+
+private:
+	friend class FSQLitePooledConnection;
+
+	void Release(TUniquePtr<FSQLiteConnection>&& Connection);
+	TUniquePtr<FSQLiteConnection> OpenConnection(bool bReadOnly);
+	bool IsHealthy(FSQLiteConnection& Connection, bool bReturning);
+	void PruneIdleConnections_Locked(double Now, TArray<TUniquePtr<FSQLiteConnection>>& OutClosed);
+	bool CheckFile() const;
+
+	/** Closes the least recently used idle connection of all pools if MaxTotalConnections is reached */
+	static void MakeRoomForConnection();
+	/** LastUsedTime of the oldest idle connection that may be closed, false if there is none */
+	bool GetOldestClosableIdleTime(double& OutLastUsedTime) const;
+	void CloseOldestIdleConnection();
+
+	const FString Filename;
+	FSQLiteConnectionPoolSettings Settings;
+	FSQLiteConnectionProfile Profile;
+
+	/** Built from Profile once. Pragmas that change the file itself only run on writable connections */
+	FString WriterPragmas;
+	FString ConnectionPragmas;
+
+	mutable FCriticalSection Mutex;
+
+	/** Idle connections, the most recently returned one last */
+	TArray<TUniquePtr<FSQLiteConnection>> IdleConnections;
+
+	/** Open connections, idle and borrowed ones, including those currently being opened */
+	int32 NumOpenConnections = 0;
+
+	/** See PinConnection() */
+	const FSQLiteConnection* PinnedConnection = nullptr;
+
+	bool bShutdown = false;
+
+	/** Connections returned inside a transaction, by the id of the thread they stay with, see Acquire() */
+	TMap<uint32, TUniquePtr<FSQLiteConnection>> TransactionConnections;
+	/** TransactionConnections.Num(), readable without the lock */
+	std::atomic<int32> NumTransactionConnections{ 0 };
+
+	/** Read-only WAL connections by thread id, see PerThreadWalReaders */
+	TMap<uint32, TSharedPtr<FSQLiteConnection, ESPMode::ThreadSafe>> ThreadReaders;
+	FRWLock ThreadReadersLock;
+
+	enum class EValidity : uint8
+	{
+		Unchecked,
+		Valid,
+		Invalid
+	};
+
+	/** See IsValidDatabase() */
+	std::atomic<EValidity> Validity{ EValidity::Unchecked };
+
+#if WITH_EDITOR
+	/** Directory watcher registration, guarded by Mutex */
+	FDelegateHandle FileWatcherHandle;
+	FString WatchedDirectory;
+#endif
+
+	/** Statement cache hits/misses of all connections */
+	FSQLiteStatementCacheCounters StatementCacheCounters;
+
+	/** Triggered whenever a connection is returned or closed */
+	FEvent* ConnectionReturnedEvent = nullptr;
+
+	static std::atomic<int32> MaxTotalConnections;
+
+	/** All pools alive, for MakeRoomForConnection(). Pools add and remove themselves */
+	static FCriticalSection AllPoolsLock;
+	static TArray<FSQLiteConnectionPool*> AllPools;
+};
@@ -2,6 +2,12 @@
 #include "sqlite3.h"
 #include "SQLiteBlueprintNodes.h"
 #include "SQLiteDatabaseStructs.h"
+#include "SQLiteConnectionPool.h"
+#include "SQLiteDatabaseRegistry.h"
+#include "SQLiteColumnarResult.h"
+#include "SQLiteRowCursor.h"
+#include "SQLiteResultArena.h"
+#include "SQLiteBindingPlan.h"
 #include "SQLiteDatabase.generated.h"
 
 USTRUCT(BlueprintType)
@@ -59,6 +65,63 @@ struct CISQLITE3_API FSQLiteQueryResult
 	UPROPERTY(BlueprintReadOnly, Category = "SQLite Query Result")
 		FString ErrorMessage;
 
+	/** Position of every column in the rows' Fields, by column name. The first one wins if names repeat */
+	UPROPERTY(BlueprintReadOnly, Category = "SQLite Query Result")
+		TMap<FString, int32> ColumnIndices;
+
+	/** Fills ColumnIndices, every row has one field per column in this order */
+	void SetColumns(const FSQLiteColumns& Columns)
+	{
+		ColumnIndices.Empty(Columns.Num());
+		for (int32 c = 0; c < Columns.Num(); c++)
+		{
+			if (!ColumnIndices.Contains(Columns[c].Name))
+			{
+				ColumnIndices.Add(Columns[c].Name, c);
+			}
+		}
+	}
+
+	/** Position of a column in the rows' Fields, INDEX_NONE if there is none with that name */
+	int32 FindColumn(const FString& Name) const
+	{
+		const int32* index = ColumnIndices.Find(Name);
+		return index ? *index : INDEX_NONE;
+	}
+
+};
+
+USTRUCT(BlueprintType)
+struct CISQLITE3_API FSQLiteTypedQueryResultRow
+{
+	GENERATED_USTRUCT_BODY()
+
+		/** One value per column, in the order of the result's Columns */
+		UPROPERTY(BlueprintReadOnly, Category = "SQLite Query Result")
+		TArray<FSQLiteValue> Values;
+};
+
+USTRUCT(BlueprintType)
+struct CISQLITE3_API FSQLiteTypedQueryResult
+{
+	GENERATED_USTRUCT_BODY()
+
+		/** Column names, stored once for all rows */
+		UPROPERTY(BlueprintReadOnly, Category = "SQLite Query Result")
+		TArray<FString> Columns;
+
+	/** The resulting rows from the query */
+	UPROPERTY(BlueprintReadOnly, Category = "SQLite Query Result")
+		TArray<FSQLiteTypedQueryResultRow> ResultRows;
+
+	/** Was the query successful or not */
+	UPROPERTY(BlueprintReadOnly, Category = "SQLite Query Result")
+		bool Success = false;
+
+	/** If the query was unsuccessful a human readable error message will be populated here */
+	UPROPERTY(BlueprintReadOnly, Category = "SQLite Query Result")
+		FString ErrorMessage;
+
 };
 
 
@@ -71,6 +134,8 @@ namespace SQLiteResultValueTypes
 		Integer,
 		Float,
 		Text,
+		Blob,
+		Null,
 		UnsupportedValueType
 	};
 }
@@ -79,43 +144,93 @@ namespace SQLiteResultValueTypes
 // an SQLITE3 query.
 struct SQLiteResultField
 {
-	FString StringValue;
-	double DoubleValue;
-	int64 IntValue;
+	double DoubleValue = 0.0;
+	int64 IntValue = 0;
+	/** TEXT (as UTF-8, the way sqlite stores it) or BLOB bytes, allocated from the result's arena */
+	const void* Data = nullptr;
+	/** Bytes of the TEXT or BLOB */
+	int32 Size = 0;
+
+	/** Index into the result's Columns, names are stored once per statement instead of per field */
+	int32 Column = INDEX_NONE;
+	SQLiteResultValueTypes::SQLiteResultValType Type = SQLiteResultValueTypes::Null;
+
+	/** The UTF-8 text without converting it, lives as long as the result's arena. Empty for other types */
+	FUtf8StringView GetUtf8Text() const
+	{
+		return Type == SQLiteResultValueTypes::Text ? FUtf8StringView(static_cast<const UTF8CHAR*>(Data), Size) : FUtf8StringView();
+	}
+	/** The text converted to TCHAR, only done when asked for */
+	FString GetText() const { return Type == SQLiteResultValueTypes::Text ? ToString() : FString(); }
+	TConstArrayView<uint8> GetBlob() const
+	{
+		return Type == SQLiteResultValueTypes::Blob ? TConstArrayView<uint8>(static_cast<const uint8*>(Data), Size) : TConstArrayView<uint8>();
+	}
 
-	FString Name;
-	SQLiteResultValueTypes::SQLiteResultValType Type;
+	/** Compares the text byte by byte, without converting it */
+	bool TextEquals(FUtf8StringView Other) const
+	{
+		return Type == SQLiteResultValueTypes::Text && Other.Len() == Size && FMemory::Memcmp(Other.GetData(), Data, Size) == 0;
+	}
+	bool TextEquals(const FString& Other) const
+	{
+		const FTCHARToUTF8 utf8(*Other);
+		return TextEquals(FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(utf8.Get()), utf8.Length()));
+	}
 
-	FString ToString()
+	FString ToString() const
 	{
-		if (Type == SQLiteResultValueTypes::Text)
-			return StringValue;
-		else if (Type == SQLiteResultValueTypes::Integer)
-			return FString::Printf(TEXT("%i"), IntValue);
+		if (Type == SQLiteResultValueTypes::Integer)
+			return FString::Printf(TEXT("%lld"), IntValue);
 		else if (Type == SQLiteResultValueTypes::Float)
-			return FString::Printf(TEXT("%f"), DoubleValue);
-
-		return StringValue;
+			return FString::Printf(TEXT("%.15g"), DoubleValue);
+		else if (Type == SQLiteResultValueTypes::Text || Type == SQLiteResultValueTypes::Blob)
+		{
+			// A BLOB reads as UTF-8 too, same as sqlite3_column_text on it
+			const FUTF8ToTCHAR converted(static_cast<const ANSICHAR*>(Data), Size);
+			return FString(converted.Length(), converted.Get());
+		}
+
+		return FString();
 	}
 };
 
-// Represents a single row in the result.
+// Represents a single row in the result, its fields live in the result's arena.
 struct SQLiteResultValue
 {
-	TArray<SQLiteResultField> Fields;
+	TArrayView<SQLiteResultField> Fields;
 };
 
 // The internal result object.
 struct SQLiteQueryResult
 {
-	bool Success;
+	bool Success = false;
 	FString ErrorMessage;
 	TArray<SQLiteResultValue> Results;
+	/** Column metadata shared by all rows, null if the query failed */
+	FSQLiteColumnsPtr Columns;
 	int InsertedId = 0;
+
+	/** Fields, text and blobs of all rows, freed together with the result */
+	FSQLiteResultArena Arena;
+
+	/** Drops the rows but keeps their memory, for running a recurring query into the same result again */
+	void Reset()
+	{
+		Success = false;
+		ErrorMessage.Reset();
+		Results.Reset();
+		Columns.Reset();
+		InsertedId = 0;
+		Arena.Reset();
+	}
 };
 
 
 
+/** Handles of databases registered with RegisterDatabasesAsync, in the order they were passed in. Invalid for failed ones. */
+DECLARE_DYNAMIC_DELEGATE_OneParam(FSQLiteDatabasesRegisteredDelegate, const TArray<FSQLiteDatabaseHandle>&, Handles);
+
 /**
 * SQLite main database class.
 */
@@ -132,18 +247,53 @@ public:
 
 	/** Checks if the database is registered, ie. that it can be found in Databases. */
 
-	/** Add a database to the list of databases. It will be checked that it's valid (will try to open it) */
+	/** Add a database to the list of databases. It will be checked that it's valid (will try to open it).
+	*   Queries borrow connections from a pool. KeepOpen uses a single connection that stays open at all times, so
+	*   temp tables, pragmas and last_insert_rowid() carry over from one call to the next.
+	*   LazyOpen defers opening the file until the first query, idle connections are closed after a minute either way. */
+	UFUNCTION(BlueprintCallable, Category = "SQLite")
+		static bool RegisterDatabase(const FString& Name, const FString& Filename, bool RelativeToGameContentDirectory, bool KeepOpen=false, bool LazyOpen=false);
+
+	/** Add a database to the list of databases with explicit connection pool settings and the pragmas
+	*   applied to each of its connections (see the connection profile presets).
+	*   Returns a handle for the handle based functions, invalid if the database couldn't be added. */
+	UFUNCTION(BlueprintCallable, Category = "SQLite", meta = (AutoCreateRefTerm = "PoolSettings,Profile"))
+		static FSQLiteDatabaseHandle RegisterDatabaseWithSettings(const FString& Name, const FString& Filename, bool RelativeToGameContentDirectory,
+			const FSQLiteConnectionPoolSettings& PoolSettings, const FSQLiteConnectionProfile& Profile);
+
+	/** Registers a list of databases on worker threads, opening their files in parallel.
+	*   OnRegistered is called on the game thread once all of them are done. */
 	UFUNCTION(BlueprintCallable, Category = "SQLite")
-		static bool RegisterDatabase(const FString& Name, const FString& Filename, bool RelativeToGameContentDirectory, bool KeepOpen=false);
+		static void RegisterDatabasesAsync(const TArray<FSQLiteDatabaseRegistration>& Registrations, FSQLiteDatabasesRegisteredDelegate OnRegistered);
+	static void RegisterDatabasesAsync(const TArray<FSQLiteDatabaseRegistration>& Registrations, TFunction<void(const TArray<FSQLiteDatabaseHandle>&)> OnRegistered);
 
-	/** Remove a database from the list of databases. Closes the database in case KeepOpen flag was set during @ref RegisterDatabase */
+	/** Remove a database from the list of databases. Closes all pooled connections to it. */
 	UFUNCTION(BlueprintCallable, Category = "SQLite")
 		static void UnregisterDatabase(const FString& Name);
 
+	/** Removes all databases, called on module shutdown. */
+	static void UnregisterAllDatabases();
+
+	/** Closes connections of all databases that were idle longer than their idle timeout, called from a ticker. */
+	static void PruneIdleConnections();
+
+	/** Caps the connections open over all databases (0 for no cap). When a query needs a new connection
+	*   beyond the cap, the least recently used idle connection of any database is closed first. */
+	UFUNCTION(BlueprintCallable, Category = "SQLite")
+		static void SetMaxOpenConnections(int32 MaxOpenConnections);
+
 	/** Checks if the database is registered, ie. that it can be found in Databases. */
 	UFUNCTION(BlueprintCallable, Category = "SQLite")
 		static bool IsDatabaseRegistered(const FString& DatabaseName);
 
+	/** Handle of a registered database, so later calls skip looking it up by name. Invalid if it isn't registered. */
+	UFUNCTION(BlueprintPure, Category = "SQLite")
+		static FSQLiteDatabaseHandle GetDatabaseHandle(const FString& DatabaseName);
+
+	/** Checks if the handle still refers to a registered database. */
+	UFUNCTION(BlueprintPure, Category = "SQLite")
+		static bool IsDatabaseHandleValid(FSQLiteDatabaseHandle Database);
+
 	/** Get data from the database using a select statement straight into an UObject, ie. populates its properties. */
 	UFUNCTION(BlueprintCallable, Category = "SQLite", meta = (DisplayName = "Get Data Into Object (manual query)"))
 		static bool GetDataIntoObject(const FString& DatabaseName, const FString& Query, UObject* ObjectToPopulate);
@@ -153,10 +303,56 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "SQLite", meta = (DisplayName = "Get Data Into Object"))
 		static bool GetDataIntoObjectBP(const FSQLiteDatabaseReference& DataSource, TArray<FString> Fields, FSQLiteQueryFinalizedQuery Query, UObject* ObjectToPopulate);
 
+	/** Runs a select statement and populates one object per row: row 0 into ObjectsToPopulate[0] and so on.
+	*   Properties are matched by name, same as Get Data Into Object. Returns the number of objects populated. */
+	UFUNCTION(BlueprintCallable, Category = "SQLite", meta = (DisplayName = "Get Data Into Objects"))
+		static int32 GetDataIntoObjects(const FString& DatabaseName, const FString& Query, const TArray<UObject*>& ObjectsToPopulate);
+
+	/** Runs a select statement and creates one object of ObjectClass per row, populated like Get Data Into Object.
+	*   Outer defaults to the transient package. */
+	UFUNCTION(BlueprintCallable, Category = "SQLite", meta = (DisplayName = "Get Data Into New Objects", DeterminesOutputType = "ObjectClass"))
+		static TArray<UObject*> GetDataIntoNewObjects(const FString& DatabaseName, const FString& Query, TSubclassOf<UObject> ObjectClass, UObject* Outer = nullptr);
+
+	/** Writes the properties of an object to the columns with the same names in TableName, replacing the row with the
+	*   same primary key (INSERT OR REPLACE). Properties without a column are skipped. */
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Query", meta = (DisplayName = "Save Object To Table"))
+		static bool SaveObjectToTable(const FString& DatabaseName, const FString& TableName, UObject* Object);
+
+	/** Writes one row per object like Save Object To Table, all in one transaction: either all rows are written or none. */
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Query", meta = (DisplayName = "Save Objects To Table"))
+		static bool SaveObjectsToTable(const FString& DatabaseName, const FString& TableName, const TArray<UObject*>& Objects);
+
+	/** Runs a select statement and replaces the contents of Structs (an array of any struct) with one element per row,
+	*   members are matched by name like the properties of Get Data Into Object. Returns false if the query failed. */
+	UFUNCTION(BlueprintCallable, CustomThunk, Category = "SQLite", meta = (DisplayName = "Get Data Into Structs", ArrayParm = "Structs"))
+		static bool GetDataIntoStructsBP(const FString& DatabaseName, const FString& Query, const TArray<int32>& Structs);
+	DECLARE_FUNCTION(execGetDataIntoStructsBP)
+	{
+		P_GET_PROPERTY(FStrProperty, DatabaseName);
+		P_GET_PROPERTY(FStrProperty, Query);
+		Stack.MostRecentProperty = nullptr;
+		Stack.StepCompiledIn<FArrayProperty>(nullptr);
+		void* arrayAddress = Stack.MostRecentPropertyAddress;
+		const FArrayProperty* arrayProperty = CastField<FArrayProperty>(Stack.MostRecentProperty);
+		if (!arrayProperty)
+		{
+			Stack.bArrayContextFailed = true;
+			return;
+		}
+		P_FINISH;
+		P_NATIVE_BEGIN;
+		*(bool*)RESULT_PARAM = GetDataIntoStructArray(GetDatabaseHandle(DatabaseName), Query, arrayProperty, arrayAddress);
+		P_NATIVE_END;
+	}
+
 	/** Get data from the database using a select statement and return the rows. */
 	UFUNCTION(BlueprintCallable, Category = "SQLite", meta = (DisplayName = "Get Data From Table(s) (manual query)"))
 		static FSQLiteQueryResult GetData(const FString& DatabaseName, const FString& Query);
 
+	/** Get data from the database using a select statement and return the rows with typed values instead of strings. */
+	UFUNCTION(BlueprintCallable, Category = "SQLite", meta = (DisplayName = "Get Typed Data From Table(s) (manual query)"))
+		static FSQLiteTypedQueryResult GetTypedData(const FString& DatabaseName, const FString& Query);
+
 	/** Blueprint: Get data from the database. Returns the resulting rows. */
 	UFUNCTION(BlueprintCallable, Category = "SQLite", meta = (DisplayName = "Get Data From Table(s)"))
 		static FSQLiteQueryResult GetDataBP(const FSQLiteDatabaseReference& DataSource, TArray<FString> Fields, FSQLiteQueryFinalizedQuery Query, int32 MaxResults = -1, int32 ResultOffset = 0);
@@ -218,29 +414,136 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "SQLite|Query", meta = (DisplayName = "Is Valid Database"))
         static bool IsValidDatabase(const FString& DatabaseFilename, bool TestByOpening);
 
+	/** Checks a registered database's file again, eg. after it was repaired or replaced outside the editor.
+	*   Queries otherwise only check it at registration and after errors that point at the file. */
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Query", meta = (DisplayName = "Revalidate Database"))
+		static bool RevalidateDatabase(const FString& DatabaseName);
+
+	/** Hit/miss counters of the prepared statement caches of a database, for sizing StatementCacheSize. */
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Query", meta = (DisplayName = "Get Statement Cache Stats"))
+		static FSQLiteStatementCacheStats GetStatementCacheStats(const FString& DatabaseName);
+
     static TArray<uint8> Dump(const FString& DatabaseFilename);
     static bool Restore(const FString& DatabaseFilename, const TArray<uint8>& data);
 
 	/** Runs a query and returns fetched rows. */
         static TUniquePtr<SQLiteQueryResult> RunQueryAndGetResults(const FString& DatabaseName, const FString& Query);
+
+	/** Runs a query into an existing result, which is Reset() first. Reusing the result for a recurring query
+	*   reuses its memory. Returns OutResult.Success. */
+	static bool RunQueryAndGetResults(const FString& DatabaseName, const FString& Query, SQLiteQueryResult& OutResult);
+
+	/** Runs a query and returns the fetched rows column by column, for large results. */
+	static FSQLiteColumnarResult RunQueryColumnar(const FString& DatabaseName, const FString& Query);
+
+	/** Runs a query and hands each row to OnRow as it is stepped, without collecting the rows.
+	*   OnRow returns false to stop early. Returns false if the query failed. */
+	static bool GetData(const FString& DatabaseName, const FString& Query, TFunctionRef<bool(const FSQLiteRowCursor& Row)> OnRow);
+
+	/** Runs a query and replaces the contents of OutStructs with one USTRUCT per row, members are matched to the
+	*   columns by name. Returns false if the query failed. */
+	template <typename StructType>
+	static bool GetDataIntoStructs(const FString& DatabaseName, const FString& Query, TArray<StructType>& OutStructs)
+	{
+		return GetDataIntoStructs(GetDatabaseHandle(DatabaseName), Query, OutStructs);
+	}
+
+	/** Borrows a connection to a registered database from its pool. Invalid if the database isn't registered or can't be opened. */
+	static FSQLitePooledConnection AcquireConnection(const FString& DatabaseName);
+
+	/** Borrows a connection suited for Query and prepares it there: read-only statements run on the calling thread's
+	*   WAL reader if the database uses PerThreadWalReaders, everything else on a pooled connection.
+	*   Returns the sqlite result code, OutConnection stays invalid if no connection could be borrowed. */
+	static int32 PrepareQuery(const FString& DatabaseName, const FString& Query, FSQLitePooledConnection& OutConnection,
+		FSQLiteCachedStatement& OutStatement);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Handle based versions of the functions above, they index straight into
+	// the registry instead of looking the database up by name.
+	//////////////////////////////////////////////////////////////////////////
+
+	UFUNCTION(BlueprintCallable, Category = "SQLite", meta = (DisplayName = "Get Data Into Object (handle)"))
+		static bool GetDataIntoObjectByHandle(FSQLiteDatabaseHandle Database, const FString& Query, UObject* ObjectToPopulate);
+
+	UFUNCTION(BlueprintCallable, Category = "SQLite", meta = (DisplayName = "Get Data From Table(s) (handle)"))
+		static FSQLiteQueryResult GetDataByHandle(FSQLiteDatabaseHandle Database, const FString& Query);
+
+	UFUNCTION(BlueprintCallable, Category = "SQLite", meta = (DisplayName = "Get Typed Data From Table(s) (handle)"))
+		static FSQLiteTypedQueryResult GetTypedDataByHandle(FSQLiteDatabaseHandle Database, const FString& Query);
+
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Query", meta = (DisplayName = "Is table exists? (handle)"))
+		static bool IsTableExistsByHandle(FSQLiteDatabaseHandle Database, const FString& TableName);
+
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Query", meta = (DisplayName = "Execute SQL (handle)"))
+		static bool ExecSqlByHandle(FSQLiteDatabaseHandle Database, const FString& Query);
+
+	static void UnregisterDatabase(FSQLiteDatabaseHandle Database);
+	static bool GetDataIntoObject(FSQLiteDatabaseHandle Database, const FString& Query, UObject* ObjectToPopulate);
+	static int32 GetDataIntoObjects(FSQLiteDatabaseHandle Database, const FString& Query, const TArray<UObject*>& ObjectsToPopulate);
+	/** ExpectedRows reserves the returned array up front. */
+	static TArray<UObject*> GetDataIntoNewObjects(FSQLiteDatabaseHandle Database, const FString& Query, UClass* ObjectClass,
+		UObject* Outer = nullptr, int32 ExpectedRows = 0);
+	static FSQLiteQueryResult GetData(FSQLiteDatabaseHandle Database, const FString& Query);
+	static bool SaveObjectToTable(FSQLiteDatabaseHandle Database, const FString& TableName, UObject* Object);
+	static bool SaveObjectsToTable(FSQLiteDatabaseHandle Database, const FString& TableName, const TArray<UObject*>& Objects);
+	static FSQLiteTypedQueryResult GetTypedData(FSQLiteDatabaseHandle Database, const FString& Query);
+	static FSQLiteTable CreateTable(FSQLiteDatabaseHandle Database, const FString& TableName,
+		const TArray<FSQLiteTableField> Fields, const FSQLitePrimaryKey PK);
+	static bool CreateIndexes(FSQLiteDatabaseHandle Database, const FString& TableName, const TArray<FSQLiteIndex> Indexes);
+	static bool CreateIndex(FSQLiteDatabaseHandle Database, const FString& TableName, const FSQLiteIndex Index);
+	static bool DropIndex(FSQLiteDatabaseHandle Database, const FString& IndexName);
+	static bool DropTable(FSQLiteDatabaseHandle Database, const FString& TableName);
+	static bool TruncateTable(FSQLiteDatabaseHandle Database, const FString& TableName);
+	static bool IsTableExists(FSQLiteDatabaseHandle Database, const FString& TableName);
+	static bool InsertRowsIntoTable(FSQLiteDatabaseHandle Database, const FString& TableName, TArray<FSQLiteTableRowSimulator> rowsOfFields);
+	static bool UpdateRowsInTable(FSQLiteDatabaseHandle Database, const FString& TableName, TArray<FSQLiteTableRowSimulator> rowsOfFields, FSQLiteQueryFinalizedQuery Query, int32 MaxResults = -1, int32 ResultOffset = 0);
+	static void DeleteRowsInTable(FSQLiteDatabaseHandle Database, const FString& TableName, FSQLiteQueryFinalizedQuery Query);
+	static bool Vacuum(FSQLiteDatabaseHandle Database);
+	static bool ExecSql(FSQLiteDatabaseHandle Database, const FString& Query);
+	static FSQLiteStatementCacheStats GetStatementCacheStats(FSQLiteDatabaseHandle Database);
+	static TArray<uint8> Dump(FSQLiteDatabaseHandle Database);
+	static bool Restore(FSQLiteDatabaseHandle Database, const TArray<uint8>& data);
+	static TUniquePtr<SQLiteQueryResult> RunQueryAndGetResults(FSQLiteDatabaseHandle Database, const FString& Query);
+	static bool RunQueryAndGetResults(FSQLiteDatabaseHandle Database, const FString& Query, SQLiteQueryResult& OutResult);
+	static FSQLiteColumnarResult RunQueryColumnar(FSQLiteDatabaseHandle Database, const FString& Query);
+	static bool GetData(FSQLiteDatabaseHandle Database, const FString& Query, TFunctionRef<bool(const FSQLiteRowCursor& Row)> OnRow);
+	template <typename StructType>
+	static bool GetDataIntoStructs(FSQLiteDatabaseHandle Database, const FString& Query, TArray<StructType>& OutStructs)
+	{
+		OutStructs.Reset();
+		return GetDataIntoStructs(Database, Query, StructType::StaticStruct(),
+			[&OutStructs]() -> void* { return &OutStructs.AddDefaulted_GetRef(); });
+	}
+	/** Writes every row into an instance of Struct returned by AddElement, which is called once per row. */
+	static bool GetDataIntoStructs(FSQLiteDatabaseHandle Database, const FString& Query, const UScriptStruct* Struct,
+		TFunctionRef<void*()> AddElement);
+	/** Same for a reflected array of structs, its elements are replaced. Used by the Blueprint node. */
+	static bool GetDataIntoStructArray(FSQLiteDatabaseHandle Database, const FString& Query, const FArrayProperty* ArrayProperty,
+		void* ArrayAddress);
+	static FSQLitePooledConnection AcquireConnection(FSQLiteDatabaseHandle Database);
+	static int32 PrepareQuery(FSQLiteDatabaseHandle Database, const FString& Query, FSQLitePooledConnection& OutConnection,
+		FSQLiteCachedStatement& OutStatement);
+
+	/** Reads the current row of a statement that was stepped to SQLITE_ROW, its fields are allocated from Arena. */
+	static void ReadResultRow(sqlite3_stmt* Statement, FSQLiteResultArena& Arena, SQLiteResultValue& OutRow);
+
+	/** Reads the current row of a statement that was stepped to SQLITE_ROW straight into the Blueprint name/value pairs. */
+	static void ReadBlueprintRow(sqlite3_stmt* Statement, const FSQLiteColumns& Columns, FSQLiteQueryResultRow& OutRow);
+
 private:
 	/** Tries to open a database. */
 	static bool CanOpenDatabase(const FString& DatabaseFilename);
-	/** Collects all properties from an UObject and maps them by the property name. */
-	static TMap<FString, FProperty*> CollectProperties(UObject* SourceObject);
 	/** Constructs an SQL query from the blueprint fed data. */
 	static FString ConstructQuery(TArray<FString> Tables, TArray<FString> Fields, FSQLiteQueryFinalizedQuery QueryObject, int32 MaxResults = -1, int32 ResultOffset = 0);
-	/** Assigns a result row's fields' values to an UObject, ie. assigns them to the properties that have the same name. */
-	static void AssignResultsToObjectProperties(const SQLiteResultValue& ResultValue, UObject* ObjectToPopulate);
-    /** @brief Prepare given statement, returns whether to keep the database open */
-	static bool PrepareStatement(const FString& DatabaseName, const FString& Query, sqlite3** Db, int32** SqlReturnCode,
-		sqlite3_stmt** PreparedStatement);
+	/** Assigns a result row's fields' values to an UObject, ie. assigns them to the properties that have the same name.
+	*   The column to property mapping is cached per class and statement, see FSQLiteBindingPlan. */
+	static void AssignResultsToObjectProperties(const SQLiteResultValue& ResultValue, const FSQLiteColumnsPtr& Columns, UObject* ObjectToPopulate);
+	/** Prepare given statement on a borrowed connection (or take it from the connection's statement cache), returns the sqlite result code */
+	static int32 PrepareStatement(const FSQLitePooledConnection& Connection, const FString& Query, FSQLiteCachedStatement& PreparedStatement);
 
 
 private:
-	/** A list of the databases for convenience, easier to refer to them by name rather than a long filename. */
-	static TMap<FString, FString> Databases;
-
-    static TMap<FString, sqlite3*> SQLite3Databases;
+	/** The registered databases with their connection pools, easier to refer to them by name or handle rather than a long filename. */
+	static FSQLiteDatabaseRegistry Databases;
 
 };
@@ -0,0 +1,80 @@
+#pragma once
+#include "SQLiteDatabaseStructs.h"
+#include "SQLiteConnectionPool.h"
+#include <atomic>
+
+/**
+* The registered databases, safe to use from any thread. Handles index straight into the slot array,
+* names are only looked up once when a handle is made.
+*
+* There is no global lock: names are spread over shards with a lock each and every slot has its own lock,
+* lookups only take them for reading. Register/unregister write-lock the name's shard and the slot involved,
+* so queries on other databases never wait for them. Lock order is shard before slot.
+*/
+class CISQLITE3_API FSQLiteDatabaseRegistry
+{
+public:
+	FSQLiteDatabaseRegistry();
+	~FSQLiteDatabaseRegistry();
+
+	FSQLiteDatabaseRegistry(const FSQLiteDatabaseRegistry&) = delete;
+	FSQLiteDatabaseRegistry& operator=(const FSQLiteDatabaseRegistry&) = delete;
+
+	/** Adds a database. Returns an invalid handle if the name is already taken. */
+	FSQLiteDatabaseHandle Add(const FString& Name, const TSharedRef<FSQLiteConnectionPool, ESPMode::ThreadSafe>& Pool);
+
+	/** Removes a database and returns its pool, null if the handle is stale. */
+	TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe> Remove(FSQLiteDatabaseHandle Handle);
+
+	/** Removes all databases and returns their pools. */
+	TArray<TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe>> RemoveAll();
+
+	/** Pools of all registered databases. */
+	TArray<TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe>> GetPools() const;
+
+	/** Handle of a registered database, invalid if there is none with that name. */
+	FSQLiteDatabaseHandle Find(const FString& Name) const;
+
+	bool IsValid(FSQLiteDatabaseHandle Handle) const;
+
+	/** Pool of a registered database, null if the handle is stale. */
+	TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe> GetPool(FSQLiteDatabaseHandle Handle) const;
+
+	/** Name a database was registered with, empty if the handle is stale. */
+	FString GetName(FSQLiteDatabaseHandle Handle) const;
+
+private:
+	struct FSlot
+	{
+		mutable FRWLock Lock;
+		FString Name;
+		TSharedPtr<FSQLiteConnectionPool, ESPMode::ThreadSafe> Pool;
+		int32 Generation = 1;
+	};
+
+	struct FShard
+	{
+		mutable FRWLock Lock;
+		TMap<FString, FSQLiteDatabaseHandle> Handles;
+	};
+
+	/** Slots live in chunks that are never moved or freed before the registry, so readers need no lock to reach them */
+	static constexpr int32 SlotsPerChunk = 64;
+	static constexpr int32 MaxChunks = 64;
+	static constexpr int32 NumShards = 16;
+
+	FSlot* FindSlot(int32 Index) const;
+	FShard& GetShard(const FString& Name) const;
+
+	/** Takes a free slot, allocating a new chunk if needed. INDEX_NONE if all slots are in use. */
+	int32 AllocateSlot();
+
+	std::atomic<FSlot*> Chunks[MaxChunks];
+	std::atomic<int32> NumSlots{ 0 };
+
+	/** Guards FreeSlots and growing the slot array */
+	FCriticalSection SlotAllocationLock;
+	TArray<int32> FreeSlots;
+
+	mutable FShard Shards[NumShards];
+};
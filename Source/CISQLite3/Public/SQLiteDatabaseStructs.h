@@ -86,3 +86,212 @@ struct CISQLITE3_API FSQLiteTable
 		bool Created = false;
 
 };
+/** Refers to a registered database without looking it up by name. Becomes invalid when the database is unregistered. */
+USTRUCT(BlueprintType)
+struct CISQLITE3_API FSQLiteDatabaseHandle
+{
+	GENERATED_USTRUCT_BODY()
+
+		/** Slot in the database registry */
+		UPROPERTY(BlueprintReadOnly, Category = "SQLite Database Handle")
+		int32 Index = INDEX_NONE;
+
+	/** Registration the slot belonged to when the handle was made, 0 is never used */
+	UPROPERTY(BlueprintReadOnly, Category = "SQLite Database Handle")
+		int32 Generation = 0;
+
+	bool IsSet() const { return Index != INDEX_NONE && Generation != 0; }
+
+	bool operator==(const FSQLiteDatabaseHandle& Other) const { return Index == Other.Index && Generation == Other.Generation; }
+	bool operator!=(const FSQLiteDatabaseHandle& Other) const { return !(*this == Other); }
+};
+
+USTRUCT(BlueprintType)
+struct CISQLITE3_API FSQLiteConnectionPoolSettings
+{
+	GENERATED_USTRUCT_BODY()
+
+		/** Connections opened at registration and never closed for being idle */
+		UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLite Connection Pool")
+		int32 MinConnections = 0;
+
+	/** Upper bound of simultaneously open connections, further borrowers wait for a connection to be returned */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLite Connection Pool")
+		int32 MaxConnections = 4;
+
+	/** Seconds an unused connection above MinConnections stays open. Negative keeps them open forever */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLite Connection Pool")
+		float IdleTimeoutSeconds = 60.0f;
+
+	/** Seconds a borrower waits for a free connection when MaxConnections are in use */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLite Connection Pool")
+		float AcquireTimeoutSeconds = 5.0f;
+
+	/** Check connections when they are handed out (no dangling transaction) and returned (no fatal error) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLite Connection Pool")
+		bool HealthCheck = true;
+
+	/** Prepared statements kept per connection, keyed by their SQL text. 0 disables the statement cache */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLite Connection Pool")
+		int32 StatementCacheSize = 64;
+
+	/** Create the database file when it doesn't exist yet, in the same open as the first connection */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLite Connection Pool")
+		bool CreateIfMissing = false;
+
+	/** Don't open the file at registration at all (only check it exists), it's opened and validated on first use.
+	*   Together with MinConnections 0 and the idle timeout, rarely used databases hold no file handle most of the time */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLite Connection Pool")
+		bool LazyOpen = false;
+
+	/** Switch the database to WAL journaling, keep a single writer connection and give every reading thread
+	*   its own read-only connection, so reads on different threads run in parallel. Overrides Min/MaxConnections */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLite Connection Pool")
+		bool PerThreadWalReaders = false;
+
+};
+
+/**
+* Pragmas applied to every connection opened to a database. Empty strings and 0 leave SQLite's default.
+*/
+USTRUCT(BlueprintType)
+struct CISQLITE3_API FSQLiteConnectionProfile
+{
+	GENERATED_USTRUCT_BODY()
+
+		/** Open the database read-only, for content that's shipped with the game */
+		UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLite Connection Profile")
+		bool ReadOnly = false;
+
+	/** PRAGMA journal_mode: DELETE, TRUNCATE, PERSIST, MEMORY, WAL or OFF. Ignored for read-only databases */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLite Connection Profile")
+		FString JournalMode;
+
+	/** PRAGMA synchronous: OFF, NORMAL, FULL or EXTRA */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLite Connection Profile")
+		FString Synchronous;
+
+	/** PRAGMA cache_size, page cache of every connection in KiB */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLite Connection Profile")
+		int32 CacheSizeKiB = 0;
+
+	/** PRAGMA mmap_size in bytes, 0 disables memory mapped I/O. Negative leaves the default */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLite Connection Profile")
+		int64 MmapSizeBytes = -1;
+
+	/** PRAGMA temp_store: DEFAULT, FILE or MEMORY */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLite Connection Profile")
+		FString TempStore;
+
+	/** PRAGMA page_size, only has an effect before the first table is created (or on the next VACUUM outside of WAL) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLite Connection Profile")
+		int32 PageSize = 0;
+
+	/** Milliseconds to retry when another connection holds a lock, instead of failing with SQLITE_BUSY right away.
+	*   Pooled connections to the same file do take each other's locks, eg. a write while a read is still being stepped.
+	*   0 fails right away */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLite Connection Profile")
+		int32 BusyTimeoutMs = 2000;
+
+	/** Shipped content: read-only, memory mapped, no syncing */
+	static FSQLiteConnectionProfile ReadOnlyContent();
+
+	/** Save games: WAL with full syncing, a crash never loses a committed save */
+	static FSQLiteConnectionProfile SaveGame();
+
+	/** Telemetry and logs: WAL without syncing, losing the last rows on a power cut is fine */
+	static FSQLiteConnectionProfile Telemetry();
+
+};
+
+/**
+* One database to register, see USQLiteDatabase::RegisterDatabasesAsync.
+*/
+USTRUCT(BlueprintType)
+struct CISQLITE3_API FSQLiteDatabaseRegistration
+{
+	GENERATED_USTRUCT_BODY()
+
+		/** The database name (not the filename) */
+		UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLite Database Registration")
+		FString Name;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLite Database Registration")
+		FString Filename;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLite Database Registration")
+		bool RelativeToGameContentDirectory = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLite Database Registration")
+		FSQLiteConnectionPoolSettings PoolSettings;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SQLite Database Registration")
+		FSQLiteConnectionProfile Profile;
+};
+
+USTRUCT(BlueprintType)
+struct CISQLITE3_API FSQLiteStatementCacheStats
+{
+	GENERATED_USTRUCT_BODY()
+
+		/** Queries that reused an already prepared statement */
+		UPROPERTY(BlueprintReadOnly, Category = "SQLite Statement Cache")
+		int64 Hits = 0;
+
+	/** Queries seen before that had to be prepared, they are cached from then on */
+	UPROPERTY(BlueprintReadOnly, Category = "SQLite Statement Cache")
+		int64 Misses = 0;
+
+	/** Statements finalized to make room for new ones */
+	UPROPERTY(BlueprintReadOnly, Category = "SQLite Statement Cache")
+		int64 Evictions = 0;
+
+	/** Queries prepared without caching them: seen for the first time, with several statements or nested */
+	UPROPERTY(BlueprintReadOnly, Category = "SQLite Statement Cache")
+		int64 Uncached = 0;
+
+};
+
+UENUM(BlueprintType)
+enum class ESQLiteValueType : uint8
+{
+	Null,
+	Integer,
+	Float,
+	Text,
+	Blob
+};
+
+/**
+* One typed cell of a query result, numbers stay numbers instead of being printed to a string and parsed back.
+*/
+USTRUCT(BlueprintType)
+struct CISQLITE3_API FSQLiteValue
+{
+	GENERATED_USTRUCT_BODY()
+
+		/** Storage class of the value, only the matching member below is set */
+		UPROPERTY(BlueprintReadOnly, Category = "SQLite Value")
+		ESQLiteValueType Type = ESQLiteValueType::Null;
+
+	UPROPERTY(BlueprintReadOnly, Category = "SQLite Value")
+		int64 IntegerValue = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "SQLite Value")
+		double FloatValue = 0.0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "SQLite Value")
+		FString TextValue;
+
+	UPROPERTY(BlueprintReadOnly, Category = "SQLite Value")
+		TArray<uint8> BlobValue;
+
+	bool IsNull() const { return Type == ESQLiteValueType::Null; }
+
+	/** The value converted the way sqlite converts between storage classes, NULL reads as 0 or empty */
+	int64 AsInteger() const;
+	double AsFloat() const;
+	FString AsString() const;
+	bool AsBoolean() const { return AsInteger() != 0; }
+
+};
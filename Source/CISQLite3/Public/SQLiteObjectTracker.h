@@ -0,0 +1,79 @@
+#pragma once
+#include "SQLiteDatabase.h"
+#include "UObject/ObjectKey.h"
+#include "SQLiteObjectTracker.generated.h"
+
+/**
+* Saves objects to a table incrementally. For every object it remembers a fingerprint of each column's value as
+* it was last tracked or saved (8 bytes per column, no copies of the values), and a save only writes the columns
+* whose fingerprint changed: "UPDATE Table SET Health = ? WHERE Id = ?" when only Health changed, nothing at all
+* for objects that didn't change.
+*
+* Objects are matched to their rows by KeyColumn, a column of the table with a property of the same name. The
+* tracker keeps the key each object was saved with, so an object whose key changed moves its row: the update sets
+* the key too, on the row with the old key.
+* Objects that weren't tracked yet are written whole, with INSERT OR REPLACE, same for updates that found no row,
+* eg. because it was deleted since the object was tracked.
+*/
+UCLASS(BlueprintType)
+class CISQLITE3_API USQLiteObjectTracker : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Creates a tracker for objects saved to TableName. Returns None on errors. */
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Object Tracker", meta = (DisplayName = "Create Object Tracker"))
+		static USQLiteObjectTracker* CreateObjectTracker(const FString& DatabaseName, const FString& TableName, const FString& KeyColumn = TEXT("Id"));
+
+	/** Remembers the current values of an object as the saved ones, eg. right after it was loaded from the table. */
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Object Tracker")
+		void Track(UObject* Object);
+
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Object Tracker")
+		void TrackObjects(const TArray<UObject*>& Objects);
+
+	/** Forgets an object, it's written whole the next time it's saved. */
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Object Tracker")
+		void Untrack(UObject* Object);
+
+	/** Whether a column of the object changed since it was tracked or saved. Untracked objects are always dirty. */
+	UFUNCTION(BlueprintPure, Category = "SQLite|Object Tracker")
+		bool IsDirty(UObject* Object) const;
+
+	/** Writes the changed columns of the objects in one transaction and remembers their new values.
+	*   Returns false on errors, then nothing was written and the remembered values are kept. */
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Object Tracker")
+		bool SaveChanges(const TArray<UObject*>& Objects);
+
+	/** Number of rows and columns written by the last SaveChanges. */
+	UFUNCTION(BlueprintPure, Category = "SQLite|Object Tracker")
+		void GetLastSaveStats(int32& RowsWritten, int32& ColumnsWritten) const;
+
+	/** Forgets the objects that were destroyed since they were tracked. */
+	void PruneSnapshots();
+
+private:
+	/** The plan for the object's class, null if its class has no property for the key column */
+	TSharedPtr<const FSQLiteBindingPlan, ESPMode::ThreadSafe> GetPlan(const UObject* Object) const;
+
+	FSQLiteDatabaseHandle Database;
+	FString TableName;
+	FString KeyColumn;
+	int32 KeyColumnIndex = INDEX_NONE;
+
+	/** Columns of the table, kept so the binding plans made for them stay cached */
+	FSQLiteColumnsPtr Columns;
+
+	struct FSnapshot
+	{
+		/** Fingerprints of the bound columns, in column order */
+		TArray<uint64> Fingerprints;
+		/** The key the object was saved with, its row is updated by it */
+		FSQLiteValue Key;
+	};
+
+	TMap<FObjectKey, FSnapshot> Snapshots;
+
+	int32 LastRowsWritten = 0;
+	int32 LastColumnsWritten = 0;
+};
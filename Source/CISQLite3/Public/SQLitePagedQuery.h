@@ -0,0 +1,53 @@
+#pragma once
+#include "SQLiteDatabase.h"
+#include "SQLitePagedQuery.generated.h"
+
+/**
+* Pages through a query by key instead of LIMIT / OFFSET. The key of the last row of a page is remembered and
+* the next page starts right after it ("WHERE Key > ? ORDER BY Key LIMIT ?"), so sqlite seeks there through the
+* key's index instead of stepping over every skipped row: page 1000 costs the same as page 1.
+*
+* The key column must be unique and indexed, eg. rowid or the primary key. The SQL text is the same for every
+* page, so the prepared statement comes from the connection's statement cache; no connection is kept borrowed
+* between pages.
+*/
+UCLASS(BlueprintType)
+class CISQLITE3_API USQLitePagedQuery : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Creates a paged query over the tables of DataSource, ordered by KeyColumn. Returns None on errors. */
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Paged Query", meta = (DisplayName = "Create Paged Query", AutoCreateRefTerm = "Query"))
+		static USQLitePagedQuery* CreatePagedQuery(const FSQLiteDatabaseReference& DataSource, TArray<FString> Fields,
+			const FSQLiteQueryFinalizedQuery& Query, const FString& KeyColumn = TEXT("rowid"), int32 PageSize = 50, bool Descending = false);
+
+	/** Returns the rows after the last page returned, or the first page after a Rewind. */
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Paged Query", meta = (DisplayName = "Next Page"))
+		FSQLiteQueryResult NextPage();
+
+	/** False once a page came back with fewer rows than the page size. */
+	UFUNCTION(BlueprintPure, Category = "SQLite|Paged Query")
+		bool HasMorePages() const { return bHasMorePages; }
+
+	/** Starts over at the first page. */
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Paged Query")
+		void Rewind();
+
+	/** Continues after a key seen earlier, eg. to restore a position that was saved. */
+	void SeekAfter(const FSQLiteValue& Key);
+
+	/** Key of the last row returned, Null before the first page. */
+	const FSQLiteValue& GetLastKey() const { return LastKey; }
+
+private:
+	FSQLiteDatabaseHandle Database;
+
+	/** SQL of the first page, and of every page after it that seeks past the last key */
+	FString FirstPageQuery;
+	FString NextPageQuery;
+
+	int32 PageSize = 50;
+	FSQLiteValue LastKey;
+	bool bHasMorePages = true;
+};
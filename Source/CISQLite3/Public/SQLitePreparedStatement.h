@@ -0,0 +1,103 @@
+#pragma once
+#include "SQLiteStatement.h"
+#include "SQLiteDatabase.h"
+#include "SQLitePreparedStatement.generated.h"
+
+/**
+* Blueprint access to a prepared statement. Prepare it once (keep a reference to it, eg. in a variable),
+* then Bind / Step / Reset it for every lookup instead of building a new query string each time.
+* Parameter indices start at 1, column indices at 0.
+*/
+UCLASS(BlueprintType)
+class CISQLITE3_API USQLitePreparedStatement : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Prepares a statement, eg. "SELECT Name FROM Actors WHERE Id = ?". Returns None on errors. */
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Prepared Statement", meta = (DisplayName = "Prepare Statement"))
+		static USQLitePreparedStatement* CreatePreparedStatement(const FString& DatabaseName, const FString& Query);
+
+	/** Releases the statement and its connection, it can't be used afterwards. Also happens when the object is destroyed. */
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Prepared Statement")
+		void Finalize();
+
+	UFUNCTION(BlueprintPure, Category = "SQLite|Prepared Statement")
+		bool IsPrepared() const;
+
+	/** Index of a named parameter (":name", "@name", "$name"), 0 if there is no such parameter. */
+	UFUNCTION(BlueprintPure, Category = "SQLite|Prepared Statement")
+		int32 GetParameterIndex(const FString& Name) const;
+
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Prepared Statement")
+		bool BindInteger(int32 Index, int64 Value);
+
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Prepared Statement")
+		bool BindFloat(int32 Index, double Value);
+
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Prepared Statement")
+		bool BindString(int32 Index, const FString& Value);
+
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Prepared Statement")
+		bool BindBytes(int32 Index, const TArray<uint8>& Value);
+
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Prepared Statement")
+		bool BindNull(int32 Index);
+
+	/** Sets all parameters back to NULL. */
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Prepared Statement")
+		bool ClearBindings();
+
+	/** Advances to the next row. Returns true if a row is available. */
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Prepared Statement")
+		bool Step();
+
+	/** Rewinds the statement so it can be stepped again, keeping the bound parameters. */
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Prepared Statement")
+		bool Reset();
+
+	/** Runs the statement to completion (eg. INSERT, UPDATE) and resets it. Returns false on errors. */
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Prepared Statement")
+		bool Execute();
+
+	/** Steps through all rows, returns them and resets the statement. */
+	UFUNCTION(BlueprintCallable, Category = "SQLite|Prepared Statement")
+		FSQLiteQueryResult ExecuteQuery();
+
+	UFUNCTION(BlueprintPure, Category = "SQLite|Prepared Statement")
+		int32 GetColumnCount() const;
+
+	UFUNCTION(BlueprintPure, Category = "SQLite|Prepared Statement")
+		FString GetColumnName(int32 Column) const;
+
+	UFUNCTION(BlueprintPure, Category = "SQLite|Prepared Statement")
+		bool IsColumnNull(int32 Column) const;
+
+	UFUNCTION(BlueprintPure, Category = "SQLite|Prepared Statement")
+		int64 GetColumnInteger(int32 Column) const;
+
+	UFUNCTION(BlueprintPure, Category = "SQLite|Prepared Statement")
+		double GetColumnFloat(int32 Column) const;
+
+	UFUNCTION(BlueprintPure, Category = "SQLite|Prepared Statement")
+		FString GetColumnString(int32 Column) const;
+
+	UFUNCTION(BlueprintPure, Category = "SQLite|Prepared Statement")
+		TArray<uint8> GetColumnBytes(int32 Column) const;
+
+	/** Rowid of the last INSERT on the statement's connection. */
+	UFUNCTION(BlueprintPure, Category = "SQLite|Prepared Statement")
+		int64 GetLastInsertRowId() const;
+
+	/** Rows changed by the last INSERT, UPDATE or DELETE on the statement's connection. */
+	UFUNCTION(BlueprintPure, Category = "SQLite|Prepared Statement")
+		int32 GetChanges() const;
+
+	/** The C++ statement, for code that wants to step it directly. */
+	FSQLiteStatement& GetStatement() { return Statement; }
+
+	virtual void BeginDestroy() override;
+
+private:
+	FSQLiteStatement Statement;
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include "Containers/Array.h"
+#include "Templates/IsTriviallyDestructible.h"
+#include "Templates/IsTriviallyCopyConstructible.h"
+
+/**
+* Bump allocator backing the rows, text and blobs of a query result. Memory comes from a few large blocks
+* instead of one heap allocation per row and cell, and is released all at once with the result.
+* Reset() rewinds it but keeps the blocks, so a result that is filled again (eg. the same query every frame)
+* doesn't touch the heap at all once it has grown to size.
+*
+* Only for trivially destructible data, nothing allocated here is ever destructed. Not thread safe.
+*/
+class CISQLITE3_API FSQLiteResultArena
+{
+public:
+	explicit FSQLiteResultArena(int32 InBlockSize = 64 * 1024);
+	~FSQLiteResultArena();
+
+	FSQLiteResultArena(FSQLiteResultArena&& Other);
+	FSQLiteResultArena& operator=(FSQLiteResultArena&& Other);
+
+	FSQLiteResultArena(const FSQLiteResultArena&) = delete;
+	FSQLiteResultArena& operator=(const FSQLiteResultArena&) = delete;
+
+	/** Uninitialized memory, valid until Reset() or Empty(). */
+	void* Allocate(SIZE_T Size, SIZE_T Alignment);
+
+	/** Default constructed array of Num elements. */
+	template <typename ElementType>
+	ElementType* AllocateArray(int32 Num)
+	{
+		static_assert(TIsTriviallyDestructible<ElementType>::Value, "The arena never runs destructors");
+		ElementType* elements = static_cast<ElementType*>(Allocate(sizeof(ElementType) * FMath::Max(Num, 0), alignof(ElementType)));
+		for (int32 i = 0; i < Num; i++)
+		{
+			new (elements + i) ElementType();
+		}
+		return elements;
+	}
+
+	/** Copy of Num elements. */
+	template <typename ElementType>
+	ElementType* Copy(const ElementType* Source, int32 Num)
+	{
+		static_assert(TIsTriviallyCopyConstructible<ElementType>::Value, "Copies are made with memcpy");
+		ElementType* elements = static_cast<ElementType*>(Allocate(sizeof(ElementType) * FMath::Max(Num, 0), alignof(ElementType)));
+		if (Num > 0)
+		{
+			FMemory::Memcpy(elements, Source, sizeof(ElementType) * Num);
+		}
+		return elements;
+	}
+
+	/** Makes all memory available again, keeping the blocks. Everything allocated so far becomes invalid. */
+	void Reset();
+
+	/** Frees all blocks. */
+	void Empty();
+
+	/** Bytes handed out since the last Reset(). */
+	SIZE_T GetUsedSize() const;
+	/** Bytes held in blocks. */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	struct FBlock
+	{
+		uint8* Data = nullptr;
+		SIZE_T Size = 0;
+	};
+
+	TArray<FBlock> Blocks;
+	/** Block allocations are taken from, INDEX_NONE before the first allocation */
+	int32 CurrentBlock = INDEX_NONE;
+	SIZE_T Offset = 0;
+	int32 BlockSize;
+};
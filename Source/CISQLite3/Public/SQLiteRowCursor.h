@@ -0,0 +1,106 @@
+#pragma once
+#include "SQLiteStatement.h"
+#include "Containers/StringView.h"
+
+/**
+* Forward-only cursor over the rows of a query. Rows are read straight from the statement as it is stepped,
+* nothing is collected, so scanning a large table runs in constant memory and the first row is usable right away.
+*
+*   FSQLiteRowCursor cursor;
+*   if (cursor.Open(TEXT("TestDatabase"), TEXT("SELECT Id, Name FROM Actors")))
+*   {
+*       for (const FSQLiteRowCursor& row : cursor)
+*       {
+*           int64 id = row.GetInt64(0);
+*       }
+*   }
+*
+* The cursor holds a pooled connection (and the prepared statement) until it is closed or destroyed.
+* Values, and especially the views returned by GetBytes, are only valid until the next step.
+*/
+class CISQLITE3_API FSQLiteRowCursor
+{
+public:
+	FSQLiteRowCursor() = default;
+	FSQLiteRowCursor(FSQLiteRowCursor&& Other) = default;
+	FSQLiteRowCursor& operator=(FSQLiteRowCursor&& Other) = default;
+
+	FSQLiteRowCursor(const FSQLiteRowCursor&) = delete;
+	FSQLiteRowCursor& operator=(const FSQLiteRowCursor&) = delete;
+
+	/** Prepares Query, rows are only read once the cursor is stepped. Returns false (and logs) on errors. */
+	bool Open(const FString& DatabaseName, const FString& Query);
+	bool Open(FSQLiteDatabaseHandle Database, const FString& Query);
+
+	/** Releases the statement and its connection. */
+	void Close();
+
+	bool IsOpen() const { return Statement.IsValid(); }
+
+	/** The statement, to bind parameters before the first step. */
+	FSQLiteStatement& GetStatement() { return Statement; }
+	const FSQLiteStatement& GetStatement() const { return Statement; }
+
+	/** Advances to the next row. Returns false at the end of the rows or on errors, see HasError(). */
+	bool Next();
+
+	/** Whether the cursor is on a row. */
+	bool HasRow() const { return bHasRow; }
+	/** Whether stepping failed, the rows read so far may be incomplete. */
+	bool HasError() const { return bStarted && !bHasRow && !Statement.IsDone(); }
+	FString GetErrorMessage() const { return Statement.GetErrorMessage(); }
+
+	/** Name, declared type and origin of every column, shared with the statement cache. */
+	FSQLiteColumnsPtr GetColumns() const { return Statement.GetColumns(); }
+	int32 NumColumns() const { return Statement.GetColumnCount(); }
+	/** Column index of a result column, INDEX_NONE if there is none with that name. */
+	int32 FindColumn(const FString& Name) const;
+
+	/** Values of the current row, converted the way sqlite3_column_* does. NULL reads as 0 or empty. */
+	int32 GetColumnType(int32 Column) const { return Statement.GetColumnType(Column); }
+	bool IsNull(int32 Column) const { return GetColumnType(Column) == SQLITE_NULL; }
+	int64 GetInt64(int32 Column) const { return Statement.GetColumnInt64(Column); }
+	double GetDouble(int32 Column) const { return Statement.GetColumnDouble(Column); }
+	FString GetText(int32 Column) const { return Statement.GetColumnString(Column); }
+	/** Copy of a value with its storage class. */
+	FSQLiteValue GetValue(int32 Column) const;
+
+	/** The text of a value as UTF-8, without converting it. Points into sqlite's row buffer. */
+	FUtf8StringView GetUtf8Text(int32 Column) const
+	{
+		const TConstArrayView<uint8> bytes = GetBytes(Column);
+		return FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(bytes.GetData()), bytes.Num());
+	}
+
+	/** Bytes of a BLOB, or the UTF-8 text of other values (not terminated). Points into sqlite's row buffer. */
+	TConstArrayView<uint8> GetBytes(int32 Column) const { return Statement.GetColumnBytes(Column); }
+
+	/** Range-for support, steps the cursor as the loop goes. The loop starts at the current row if the cursor is on one. */
+	class FIterator
+	{
+	public:
+		explicit FIterator(FSQLiteRowCursor* InCursor) : Cursor(InCursor) {}
+
+		const FSQLiteRowCursor& operator*() const { return *Cursor; }
+		FIterator& operator++()
+		{
+			if (!Cursor->Next())
+			{
+				Cursor = nullptr;
+			}
+			return *this;
+		}
+		bool operator!=(const FIterator& Other) const { return Cursor != Other.Cursor; }
+
+	private:
+		FSQLiteRowCursor* Cursor;
+	};
+
+	FIterator begin();
+	FIterator end() { return FIterator(nullptr); }
+
+private:
+	FSQLiteStatement Statement;
+	bool bStarted = false;
+	bool bHasRow = false;
+};
@@ -0,0 +1,124 @@
+#pragma once
+#include "sqlite3.h"
+#include "SQLiteConnectionPool.h"
+#include "SQLiteStatementCache.h"
+#include "Containers/ArrayView.h"
+
+/**
+* A prepared statement with typed parameter binding, for queries that are run over and over again.
+* Prepare once, then Bind / Step / Reset as often as needed, the compiled plan is reused every time.
+*
+* The statement only borrows a connection of its database's pool while it runs: from Prepare or the first Step
+* until it's done, fails or is Reset. Then the connection goes back to the pool (and the compiled statement to the
+* connection's statement cache) and the next Step borrows one again, so statements kept alive between uses hold
+* no connection and no locks. The bound parameters are kept by the statement and bound again.
+* A statement stepped to a row but neither finished nor reset keeps its connection and the locks that come with it.
+* Read-only statements of databases with PerThreadWalReaders use the stepping thread's reader.
+* Parameter indices start at 1, column indices at 0, same as in sqlite.
+*/
+class CISQLITE3_API FSQLiteStatement
+{
+public:
+	FSQLiteStatement() = default;
+	FSQLiteStatement(FSQLiteStatement&& Other) = default;
+	FSQLiteStatement& operator=(FSQLiteStatement&& Other);
+	~FSQLiteStatement();
+
+	FSQLiteStatement(const FSQLiteStatement&) = delete;
+	FSQLiteStatement& operator=(const FSQLiteStatement&) = delete;
+
+	/** Prepares Query on a connection of a registered database. Returns false (and logs) on errors. */
+	bool Prepare(const FString& DatabaseName, const FString& Query);
+	bool Prepare(FSQLiteDatabaseHandle Database, const FString& Query);
+
+	/** Releases the statement and the borrowed connection. */
+	void Finalize();
+
+	/** Returns the borrowed connection to the pool now, the statement stays prepared. Same as Reset(). */
+	void ReleaseConnection();
+
+	/** Whether the statement is prepared. */
+	bool IsValid() const { return !Query.IsEmpty(); }
+	/** The sqlite statement while it runs (between the first Step and the end or Reset), null otherwise. */
+	sqlite3_stmt* Get() const { return Statement.Get(); }
+
+	/** Number of parameters, parameter indices go from 1 to this. */
+	int32 GetParameterCount() const;
+	/** Index of a named parameter (":name", "@name", "$name"), 0 if there is no such parameter. */
+	int32 GetParameterIndex(const FString& Name) const;
+
+	bool Bind(int32 Index, int32 Value);
+	bool Bind(int32 Index, int64 Value);
+	bool Bind(int32 Index, double Value);
+	bool Bind(int32 Index, const FString& Value);
+	bool Bind(int32 Index, const TArray<uint8>& Value);
+	/** Binds a typed value with its storage class. */
+	bool Bind(int32 Index, const FSQLiteValue& Value);
+	bool BindNull(int32 Index);
+
+	/** Sets all parameters back to NULL. */
+	bool ClearBindings();
+
+	/** Advances to the next row. Returns true if a row is available, false when done or on errors (see IsDone()). */
+	bool Step();
+
+	/** Whether the last Step() ran through all rows without an error. */
+	bool IsDone() const { return LastResultCode == SQLITE_DONE; }
+
+	/** Rewinds the statement so it can be stepped again, keeping the bound parameters. Returns the connection. */
+	bool Reset();
+
+	int32 GetColumnCount() const;
+	FString GetColumnName(int32 Column) const;
+	/** Name, declared type and origin of every result column, resolved once and kept with the prepared statement. */
+	FSQLiteColumnsPtr GetColumns() const;
+	/** One of SQLITE_INTEGER, SQLITE_FLOAT, SQLITE_TEXT, SQLITE_BLOB or SQLITE_NULL for the current row. */
+	int32 GetColumnType(int32 Column) const;
+	int64 GetColumnInt64(int32 Column) const;
+	double GetColumnDouble(int32 Column) const;
+	FString GetColumnString(int32 Column) const;
+	TArray<uint8> GetColumnBlob(int32 Column) const;
+	/** Bytes of a BLOB, or the UTF-8 text of other values, without copying them. Only valid until the next Step() or Reset(). */
+	TConstArrayView<uint8> GetColumnBytes(int32 Column) const;
+
+	/** Rowid of the last INSERT on the statement's connection, as it was when the statement finished. */
+	int64 GetLastInsertRowId() const;
+	/** Rows changed by the last INSERT, UPDATE or DELETE on the statement's connection, as it was when the statement finished. */
+	int32 GetChanges() const;
+
+	/** Last sqlite result code of this statement. */
+	int32 GetLastResultCode() const { return LastResultCode; }
+	/** Error message of the statement's connection. */
+	FString GetErrorMessage() const;
+
+	/** Binds a value to a parameter of any prepared statement. */
+	static int32 BindValue(sqlite3_stmt* RawStatement, int32 Index, const FSQLiteValue& Value);
+
+private:
+	/** Borrows a connection, takes the statement from its cache (or prepares it there) and binds the parameters again */
+	bool Attach();
+	/** Returns statement and connection, keeping what is still asked for afterwards (insert id, changes, error) */
+	void Detach();
+	bool CheckBind(int32 Index, int32 ResultCode);
+	int32 BindValue(int32 Index, const FSQLiteValue& Value) const { return BindValue(Statement.Get(), Index, Value); }
+
+	FSQLiteDatabaseHandle Database;
+	FString Query;
+	FSQLiteColumnsPtr Columns;
+
+	/** Names of the parameters by index - 1, empty for "?" */
+	TArray<FString> ParameterNames;
+	/** Values bound to the parameters by index - 1, bound again whenever the statement is attached */
+	TArray<FSQLiteValue> Parameters;
+
+	/** Declared before Statement so the statement is returned to the connection's cache first */
+	FSQLitePooledConnection Connection;
+	FSQLiteCachedStatement Statement;
+
+	int32 LastResultCode = SQLITE_OK;
+
+	/** Taken from the connection when it was returned */
+	int64 LastInsertRowId = 0;
+	int32 Changes = 0;
+	FString ErrorMessage;
+};
@@ -0,0 +1,135 @@
+#pragma once
+#include "sqlite3.h"
+#include "Templates/SharedPointer.h"
+#include <atomic>
+
+class FSQLiteStatementCache;
+
+/** Metadata of one result column, resolved once per prepared statement. */
+struct CISQLITE3_API FSQLiteColumnInfo
+{
+	FString Name;
+	/** Declared type of the table column ("INTEGER", "TEXT", ...), empty for expressions */
+	FString DeclaredType;
+	/** Table the column comes from, only filled in if sqlite was built with SQLITE_ENABLE_COLUMN_METADATA */
+	FString OriginTable;
+};
+
+/** The result columns of a statement, shared by every result read from it. Rows refer to columns by index. */
+typedef TArray<FSQLiteColumnInfo> FSQLiteColumns;
+typedef TSharedPtr<const FSQLiteColumns, ESPMode::ThreadSafe> FSQLiteColumnsPtr;
+
+/** Hit/miss counters shared by all statement caches of one connection pool. */
+struct CISQLITE3_API FSQLiteStatementCacheCounters
+{
+	std::atomic<int64> Hits{ 0 };
+	std::atomic<int64> Misses{ 0 };
+	std::atomic<int64> Evictions{ 0 };
+	std::atomic<int64> Uncached{ 0 };
+};
+
+/**
+* A prepared statement handed out by a statement cache. Reset and cleared when released,
+* statements that could not be cached are finalized instead.
+*/
+class CISQLITE3_API FSQLiteCachedStatement
+{
+public:
+	FSQLiteCachedStatement() = default;
+	FSQLiteCachedStatement(FSQLiteCachedStatement&& Other);
+	FSQLiteCachedStatement& operator=(FSQLiteCachedStatement&& Other);
+	~FSQLiteCachedStatement();
+
+	FSQLiteCachedStatement(const FSQLiteCachedStatement&) = delete;
+	FSQLiteCachedStatement& operator=(const FSQLiteCachedStatement&) = delete;
+
+	bool IsValid() const { return Statement != nullptr; }
+	sqlite3_stmt* Get() const { return Statement; }
+
+	/** Whether the SQL text contained more than one statement, only the first one was prepared. */
+	bool HasTail() const { return bHasTail; }
+
+	/** The statement's result columns, resolved on first use and kept with the cached statement. */
+	FSQLiteColumnsPtr GetColumns() const;
+
+	/** Returns the statement to its cache early. */
+	void Release();
+
+private:
+	friend class FSQLiteStatementCache;
+
+	/** Null for statements that are not cached */
+	FSQLiteStatementCache* Cache = nullptr;
+	int32 EntryIndex = INDEX_NONE;
+	sqlite3_stmt* Statement = nullptr;
+	bool bHasTail = false;
+
+	/** Columns of statements that are not cached, and the statement's re-prepare count they were resolved at */
+	mutable FSQLiteColumnsPtr UncachedColumns;
+	mutable int32 UncachedColumnsReprepares = 0;
+};
+
+/**
+* Bounded LRU cache of prepared statements of one connection, keyed by SQL text, so hot queries
+* are parsed and planned once per connection. Not thread safe, same as the connection it belongs to.
+*
+* A query is only cached the second time it's seen: SQL built with literals (eg. one INSERT per row) is never
+* repeated and would only push the hot statements out. Text with several statements is never cached either.
+*/
+class CISQLITE3_API FSQLiteStatementCache
+{
+public:
+	FSQLiteStatementCache(sqlite3* InDb, int32 InCapacity, FSQLiteStatementCacheCounters& InCounters);
+	~FSQLiteStatementCache();
+
+	/** Hands out a reset statement for Query, preparing it on a miss. Returns the sqlite result code.
+	*   OutStatement stays invalid if Query contains no statement at all (empty or only comments). */
+	int32 Acquire(const FString& Query, FSQLiteCachedStatement& OutStatement);
+
+	/** Finalizes all cached statements, none of them may be handed out. */
+	void Empty();
+
+	int32 Num() const { return Index.Num(); }
+
+	/** Reads the column metadata of a prepared statement. */
+	static FSQLiteColumnsPtr ResolveColumns(sqlite3_stmt* Statement);
+
+private:
+	friend class FSQLiteCachedStatement;
+
+	void Release(int32 EntryIndex);
+	FSQLiteColumnsPtr GetColumns(int32 EntryIndex);
+
+	struct FEntry
+	{
+		FString Sql;
+		sqlite3_stmt* Statement = nullptr;
+		uint64 LastUsed = 0;
+		bool bInUse = false;
+		bool bHasTail = false;
+		FSQLiteColumnsPtr Columns;
+		/** SQLITE_STMTSTATUS_REPREPARE when Columns were resolved */
+		int32 ColumnsReprepares = 0;
+	};
+
+	/** Statements differing only in the case of a literal must not share an entry */
+	struct FCaseSensitiveKeyFuncs : BaseKeyFuncs<TPair<FString, int32>, FString, false>
+	{
+		static const FString& GetSetKey(const TPair<FString, int32>& Element) { return Element.Key; }
+		static bool Matches(const FString& A, const FString& B) { return A.Equals(B, ESearchCase::CaseSensitive); }
+		static uint32 GetKeyHash(const FString& Key) { return FCrc::StrCrc32(*Key); }
+	};
+
+	sqlite3* Db;
+	int32 Capacity;
+	FSQLiteStatementCacheCounters& Counters;
+
+	/** Slots are reused on eviction, so an index stays valid while its statement is handed out */
+	TArray<FEntry> Entries;
+	TMap<FString, int32, FDefaultSetAllocator, FCaseSensitiveKeyFuncs> Index;
+	uint64 UseCounter = 0;
+
+	/** Hashes of queries seen once plus one (0 is an empty slot), by hash modulo the size. A collision only caches
+	*   a query one use early */
+	TArray<uint64> SeenQueries;
+};